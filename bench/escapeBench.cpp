@@ -0,0 +1,113 @@
+/*
+ * escapeBench.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ *
+ * Compares mysqlEscape() (SIMD), mysqlEscapeScalar() and
+ * mysql_real_escape_string() on short, long and escape-heavy inputs.
+ *
+ * Client library needs a connection to know the charset, without the server
+ * the handle from mysql_init() is used (default charset of the library).
+ *
+ * build:
+ *   clang++ -std=c++11 -O2 -mavx2 -Isrc bench/escapeBench.cpp src/lightmysql/escape.cpp \
+ *      -lmysqlclient -o escapeBench
+ *
+ * run:
+ *   ./escapeBench [host user password]
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <mysql/mysql.h>
+#include "lightmysql/escape.h"
+
+using namespace LightMySQL;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Input {
+	const char *name;
+	std::vector<std::string> strings;
+	std::size_t bytes;
+};
+
+static Input makeInput(const char *name, const std::string &pattern, std::size_t length, std::size_t count) {
+	Input in;
+	in.name = name;
+	in.bytes = 0;
+	for (std::size_t i = 0; i < count; i++) {
+		std::string s;
+		//shift the pattern to change alignment of special characters
+		for (std::size_t j = 0; s.length() < length; j++) s.push_back(pattern[(i + j) % pattern.length()]);
+		in.bytes += s.length();
+		in.strings.push_back(s);
+	}
+	return in;
+}
+
+static volatile std::size_t sink;
+
+template<typename Fn>
+static void run(const char *name, const Input &in, Fn fn) {
+	std::vector<char> buff;
+	for (std::size_t i = 0; i < in.strings.size(); i++)
+		if (in.strings[i].length() * 2 + 1 > buff.size()) buff.resize(in.strings[i].length() * 2 + 1);
+	const int rounds = 20;
+	std::size_t total = 0;
+	//warm up
+	for (std::size_t i = 0; i < in.strings.size(); i++)
+		total += fn(&buff[0],in.strings[i].data(),in.strings[i].length());
+	Clock::time_point start = Clock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (std::size_t i = 0; i < in.strings.size(); i++) {
+			const std::string &s = in.strings[i];
+			total += fn(&buff[0],s.data(),s.length());
+		}
+	}
+	double t = std::chrono::duration<double>(Clock::now() - start).count();
+	sink = total;
+	printf("  %-26s %8.1f MB/s %8.1f ns/string\n",name,
+			in.bytes * rounds / t / 1e6,t * 1e9 / rounds / in.strings.size());
+}
+
+int main(int argc, char **argv) {
+	MYSQL *m = mysql_init(0);
+	if (argc >= 4) {
+		if (!mysql_real_connect(m,argv[1],argv[2],argv[3],0,0,0,0) || mysql_set_character_set(m,"utf8mb4")) {
+			fprintf(stderr,"%s\n",mysql_error(m));
+			return 2;
+		}
+	} else {
+		printf("Server is not specified, mysql_real_escape_string() uses the default charset\n");
+	}
+
+	const std::string text = "Lorem ipsum dolor sit amet, consectetur adipiscing elit. ";
+	const std::string utf8 = "P\xC5\x99\xC3\xAD\xC5\xA1" "ern\xC4\x9B" " \xC5\xBElu\xC5\xA5ou\xC4\x8Dk\xC3\xBD k\xC5\xAF\xC5\x88 ";
+	const std::string heavy = "it's \"quoted\"\\\n";
+	Input inputs[] = {
+		makeInput("short (16 B)",text,16,100000),
+		makeInput("long (4 KB)",text,4096,1000),
+		makeInput("utf-8 text (256 B)",utf8,256,10000),
+		makeInput("escape heavy (256 B)",heavy,256,10000)
+	};
+
+	for (std::size_t i = 0; i < sizeof(inputs)/sizeof(inputs[0]); i++) {
+		const Input &in = inputs[i];
+		printf("%s\n",in.name);
+		run("mysqlEscape",in,[](char *t, const char *s, std::size_t l) {
+			return mysqlEscape(t,s,l,escUtf8mb4);
+		});
+		run("mysqlEscapeScalar",in,[](char *t, const char *s, std::size_t l) {
+			return mysqlEscapeScalar(t,s,l,escUtf8mb4);
+		});
+		run("mysql_real_escape_string",in,[m](char *t, const char *s, std::size_t l) {
+			return (std::size_t)mysql_real_escape_string(m,t,s,(unsigned long)l);
+		});
+	}
+	mysql_close(m);
+	return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * jsonServerBench.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ *
+ * Compares JSON generated by the client (ResultJsonWriter, DBResultToJSON)
+ * with JSON generated by the server (DBResultToJSON::getServerQuery).
+ * Needs running mysqld (MySQL 5.7.22+ or MariaDB 10.5+) and a database,
+ * where the benchmark can create temporary tables.
+ *
+ * build:
+ *   clang++ -std=c++11 -O2 -Isrc -I../lightspeed/src bench/jsonServerBench.cpp \
+ *      -Llib -llightmysql -llightspeed -lmysqlclient -lpthread -o jsonServerBench
+ *
+ * run:
+ *   ./jsonServerBench <host> <user> <password> <database> [rows]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <lightspeed/base/containers/autoArray.tcc>
+#include "lightmysql/connection.h"
+#include "lightmysql/query.h"
+#include "lightmysql/result.h"
+#include "lightmysql/json.h"
+#include "lightmysql/resultJsonWriter.h"
+
+using namespace LightSpeed;
+using namespace LightMySQL;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Schema {
+	const char *name;
+	const char *create;
+	const char *insert;
+	const char *select;
+	///configures the converter
+	void (*setup)(DBResultToJSON &conv);
+};
+
+static void setupOrders(DBResultToJSON &) {}
+
+static void setupProfiles(DBResultToJSON &conv) {
+	conv.setFormat("tags",DBResultToJSON::set);
+	conv.setFormat("attrs",DBResultToJSON::jsonstr);
+	conv.setFormat("active",DBResultToJSON::boolean);
+	conv.setGroup("addr_");
+}
+
+static const Schema schemas[] = {
+	{
+		"orders (numbers, dates)",
+		"CREATE TEMPORARY TABLE bench_orders (id INT PRIMARY KEY, customer INT, "
+			"price DECIMAL(10,2), weight DOUBLE, created DATETIME, note VARCHAR(64))",
+		"INSERT INTO bench_orders VALUES (%1, %2, %3, %4, FROM_UNIXTIME(%5), %6)",
+		"SELECT id, customer, price, weight, created, note FROM bench_orders",
+		&setupOrders
+	},
+	{
+		"profiles (strings, sets, json)",
+		"CREATE TEMPORARY TABLE bench_profiles (id INT PRIMARY KEY, name VARCHAR(64), "
+			"tags SET('admin','editor','viewer','beta'), attrs TEXT, active VARCHAR(5), "
+			"addr_city VARCHAR(32), addr_zip VARCHAR(8))",
+		"INSERT INTO bench_profiles VALUES (%1, %6, 'editor,beta', "
+			"'{\"theme\":\"dark\",\"size\":[1,2,3]}', 'true', 'Prague', '11000')",
+		"SELECT id, name, tags, attrs, active, addr_city, addr_zip FROM bench_profiles",
+		&setupProfiles
+	}
+};
+
+static void fill(Query &q, const Schema &s, natural rows) {
+	q(s.create).exec();
+	q("START TRANSACTION").exec();
+	for (natural i = 0; i < rows; i++) {
+		q(s.insert).arg(i).arg(i % 1000).arg((double)(i % 10000) / 100)
+			.arg((double)i / 7).arg(1500000000 + i * 60).arg("note \"quoted\"").exec();
+	}
+	q("COMMIT").exec();
+}
+
+static double seconds(Clock::time_point start) {
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void report(const char *name, double t, natural bytes, natural iterations) {
+	printf("  %-28s %10.3f ms %12lu bytes\n",name,t * 1000 / iterations,(unsigned long)bytes);
+}
+
+static void benchmark(Connection &conn, const Schema &s, natural iterations) {
+	JSON::PFactory factory = JSON::create();
+	Query q(conn);
+	printf("%s\n",s.name);
+
+	//client: JSON text written by ResultJsonWriter
+	natural bytes = 0;
+	Clock::time_point start = Clock::now();
+	for (natural i = 0; i < iterations; i++) {
+		Result res = q(s.select).exec();
+		ResultJsonWriter wr(factory,res,true);
+		s.setup(wr);
+		AutoArray<char> out;
+		wr.writeRows(res,out);
+		bytes = out.length();
+	}
+	report("client, writer",seconds(start),bytes,iterations);
+
+	//client: JSON nodes built by DBResultToJSON and serialized
+	start = Clock::now();
+	for (natural i = 0; i < iterations; i++) {
+		Result res = q(s.select).exec();
+		DBResultToJSON conv(factory,res,true);
+		s.setup(conv);
+		JSON::PNode arr = factory->newArray();
+		while (res.hasItems()) arr->add(conv.getRow(res.getNext()));
+		bytes = factory->toString(*arr).length();
+	}
+	report("client, nodes",seconds(start),bytes,iterations);
+
+	//server: the server returns single JSON array
+	Result meta = q(StringA(ConstStrA(s.select) + ConstStrA(" LIMIT 0"))).exec();
+	DBResultToJSON conv(factory,meta,true);
+	s.setup(conv);
+	StringA aggQuery = conv.getServerQuery(s.select,true);
+	StringA rowQuery = conv.getServerQuery(s.select,false);
+	start = Clock::now();
+	for (natural i = 0; i < iterations; i++) {
+		Result res = conn.executeQuery(aggQuery);
+		bytes = res.getNext()[0].as<ConstStrA>().length();
+	}
+	report("server, JSON_ARRAYAGG",seconds(start),bytes,iterations);
+
+	//server: one JSON per row, rows are joined by the client
+	start = Clock::now();
+	for (natural i = 0; i < iterations; i++) {
+		Result res = conn.executeQuery(rowQuery);
+		AutoArray<char> out;
+		out.add('[');
+		while (res.hasItems()) {
+			if (out.length() > 1) out.add(',');
+			out.append(res.getNext()[0].as<ConstStrA>());
+		}
+		out.add(']');
+		bytes = out.length();
+	}
+	report("server, JSON_OBJECT per row",seconds(start),bytes,iterations);
+}
+
+int main(int argc, char **argv) {
+	if (argc < 5) {
+		fprintf(stderr,"Usage: %s <host> <user> <password> <database> [rows]\n",argv[0]);
+		return 1;
+	}
+	natural rows = argc > 5?(natural)atol(argv[5]):10000;
+	natural iterations = 10;
+	try {
+		Connection conn(ConnectParams(argv[1],3306,AuthInfo_t(argv[2],argv[3]),argv[4]));
+		Query q(conn);
+		for (natural i = 0; i < sizeof(schemas)/sizeof(schemas[0]); i++) {
+			fill(q,schemas[i],rows);
+			benchmark(conn,schemas[i],iterations);
+		}
+	} catch (const std::exception &e) {
+		fprintf(stderr,"%s\n",e.what());
+		return 2;
+	}
+	return 0;
+}
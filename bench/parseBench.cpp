@@ -0,0 +1,170 @@
+/*
+ * parseBench.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ *
+ * Compares parsers of the numeric fields (parseIntField(), parseFloatField())
+ * with strtoll(), strtoull() and strtod() on values formatted the same way
+ * as the server sends them: ids, BIGINT keys, signed amounts, DECIMAL(10,2)
+ * prices and DOUBLE measurements. Results of both parsers are also compared.
+ *
+ * build:
+ *   clang++ -std=c++11 -O2 -Isrc -I../lightspeed/src bench/parseBench.cpp \
+ *      -Llib -llightmysql -llightspeed -lmysqlclient -lpthread -o parseBench
+ *
+ * run:
+ *   ./parseBench [rows]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "lightmysql/numberParse.h"
+
+using namespace LightSpeed;
+using namespace LightMySQL;
+
+typedef std::chrono::steady_clock Clock;
+
+enum ColumnType {
+	colInt,
+	colUInt,
+	colDouble
+};
+
+struct Column {
+	const char *name;
+	ColumnType type;
+	std::vector<std::string> values;
+	std::size_t bytes;
+};
+
+static std::string format(const char *fmt, ...) __attribute__((format(printf,1,2)));
+
+static std::string format(const char *fmt, ...) {
+	char buff[64];
+	va_list args;
+	va_start(args,fmt);
+	int l = vsnprintf(buff,sizeof(buff),fmt,args);
+	va_end(args);
+	return std::string(buff,l);
+}
+
+static unsigned long long random64() {
+	return ((unsigned long long)rand() << 42) ^ ((unsigned long long)rand() << 21) ^ (unsigned long long)rand();
+}
+
+static void makeColumns(std::vector<Column> &cols, std::size_t rows) {
+	Column c[] = {
+		{"id INT",colInt,std::vector<std::string>(),0},
+		{"key BIGINT UNSIGNED",colUInt,std::vector<std::string>(),0},
+		{"amount BIGINT",colInt,std::vector<std::string>(),0},
+		{"price DECIMAL(10,2)",colDouble,std::vector<std::string>(),0},
+		{"weight DOUBLE",colDouble,std::vector<std::string>(),0},
+		{"ratio DOUBLE (exponent)",colDouble,std::vector<std::string>(),0}
+	};
+	srand(12345);
+	for (std::size_t i = 0; i < rows; i++) {
+		c[0].values.push_back(format("%lu",(unsigned long)(i + 1)));
+		c[1].values.push_back(format("%llu",random64()));
+		c[2].values.push_back(format("%lld",(long long)(random64() % 20000000) - 10000000));
+		c[3].values.push_back(format("%d.%02d",rand() % 100000,rand() % 100));
+		c[4].values.push_back(format("%.17g",(double)rand() / 7));
+		c[5].values.push_back(format("%.15g",(double)rand() * 1e-12));
+	}
+	for (std::size_t k = 0; k < sizeof(c)/sizeof(c[0]); k++) {
+		c[k].bytes = 0;
+		for (std::size_t i = 0; i < rows; i++) c[k].bytes += c[k].values[i].length();
+		cols.push_back(c[k]);
+	}
+}
+
+static volatile double sink;
+
+///parses the column by the parsers of the library
+static double parseField(const Column &c) {
+	double sum = 0;
+	for (std::size_t i = 0; i < c.values.size(); i++) {
+		ConstStrA v(c.values[i].data(),c.values[i].length());
+		switch (c.type) {
+		case colInt: sum += (double)parseIntField<long long>(v);break;
+		case colUInt: sum += (double)parseIntField<unsigned long long>(v);break;
+		case colDouble: sum += parseFloatField<double>(v);break;
+		}
+	}
+	return sum;
+}
+
+///parses the column by the functions of the C library
+static double parseStrto(const Column &c) {
+	double sum = 0;
+	char *endp;
+	for (std::size_t i = 0; i < c.values.size(); i++) {
+		const char *v = c.values[i].c_str();
+		switch (c.type) {
+		case colInt: sum += (double)strtoll(v,&endp,10);break;
+		case colUInt: sum += (double)strtoull(v,&endp,10);break;
+		case colDouble: sum += strtod(v,&endp);break;
+		}
+		if (*endp) abort();
+	}
+	return sum;
+}
+
+///compares results of both parsers, value by value
+static std::size_t verify(const Column &c) {
+	std::size_t errors = 0;
+	for (std::size_t i = 0; i < c.values.size(); i++) {
+		ConstStrA v(c.values[i].data(),c.values[i].length());
+		const char *s = c.values[i].c_str();
+		bool ok = true;
+		switch (c.type) {
+		case colInt: ok = parseIntField<long long>(v) == strtoll(s,0,10);break;
+		case colUInt: ok = parseIntField<unsigned long long>(v) == strtoull(s,0,10);break;
+		case colDouble: ok = parseFloatField<double>(v) == strtod(s,0);break;
+		}
+		if (!ok && errors++ < 5) printf("  mismatch: %s\n",s);
+	}
+	return errors;
+}
+
+template<typename Fn>
+static double run(const Column &c, Fn fn) {
+	const int rounds = 20;
+	double total = fn(c);
+	Clock::time_point start = Clock::now();
+	for (int r = 0; r < rounds; r++) total += fn(c);
+	double t = std::chrono::duration<double>(Clock::now() - start).count();
+	sink = total;
+	return t * 1e9 / rounds / c.values.size();
+}
+
+int main(int argc, char **argv) {
+	std::size_t rows = argc > 1?(std::size_t)atol(argv[1]):200000;
+	std::vector<Column> cols;
+	makeColumns(cols,rows);
+
+	std::size_t errors = 0;
+	double fieldTotal = 0, strtoTotal = 0;
+	printf("%-26s %12s %12s %8s\n","column","parseField","strtoX","speedup");
+	for (std::size_t k = 0; k < cols.size(); k++) {
+		const Column &c = cols[k];
+		errors += verify(c);
+		double tf = run(c,parseField);
+		double ts = run(c,parseStrto);
+		fieldTotal += tf;
+		strtoTotal += ts;
+		printf("%-26s %9.1f ns %9.1f ns %7.2fx   (%.1f B/value)\n",c.name,tf,ts,ts / tf,
+				(double)c.bytes / c.values.size());
+	}
+	printf("%-26s %9.1f ns %9.1f ns %7.2fx\n","row (all columns)",fieldTotal,strtoTotal,strtoTotal / fieldTotal);
+	if (errors) {
+		printf("%lu values differ\n",(unsigned long)errors);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * asyncCoro.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "asyncCoro.h"
+
+#ifdef LIGHTMYSQL_CORO
+
+#include "exception.h"
+
+namespace LightMySQL {
+
+static Connection &directConnection(IConnection &conn) {
+	Connection *c = conn.getDirectConnection();
+	if (c == 0) throw NoDirectConnectionException_t(THISLOCATION);
+	return *c;
+}
+
+AsyncExec Query::execAsync(AsyncReactor &reactor) {
+	if (queryText.empty())
+		throw EmptyQueryException_t(THISLOCATION);
+	Connection &c = directConnection(conn);
+	build();
+	paramBuffer.clear();
+	paramEnds.clear();
+	executed = true;
+	lastCmd = cmdNotSet;
+	return AsyncExec(reactor,c,queryBuffer);
+}
+
+AsyncTrnStep::AsyncTrnStep(AsyncTransaction &trn, Action op)
+	:trn(trn),op(op),count(0),pos(0)
+{
+	switch (op) {
+	case actStart:
+		if (trn.state == AsyncTransaction::stReady || trn.state == AsyncTransaction::stRecovered) {
+			if (trn.needRollback) actions[count++] = actRollback;
+			if (trn.delay) actions[count++] = actDelay;
+			if (Connection::getIsolationLevelName(trn.level)) actions[count++] = actLevel;
+			actions[count++] = actStart;
+		}
+		break;
+	case actCommit:
+		if (trn.state == AsyncTransaction::stStarted) actions[count++] = actCommit;
+		break;
+	case actRollback:
+		//recovered transaction is abandoned, it is not repeated
+		if (trn.state == AsyncTransaction::stStarted || trn.state == AsyncTransaction::stRecovered)
+			actions[count++] = actRollback;
+		break;
+	default:
+		break;
+	}
+}
+
+void AsyncTrnStep::next() {
+	if (pos == count) {
+		resume();
+		return;
+	}
+	//function can be called by the reactor, exceptions must not leave it
+	try {
+		switch (actions[pos++]) {
+		case actRollback:
+			trn.reactor.execute(trn.conn,"ROLLBACK",*this);
+			break;
+		case actDelay:
+			trn.reactor.schedule(trn.delay,*this);
+			break;
+		case actLevel:
+			trn.reactor.execute(trn.conn,StringA(ConstStrA("SET TRANSACTION ISOLATION LEVEL ")
+					+ ConstStrA(Connection::getIsolationLevelName(trn.level))),*this);
+			break;
+		case actStart:
+			trn.reactor.execute(trn.conn,"START TRANSACTION",*this);
+			break;
+		case actCommit:
+			trn.reactor.execute(trn.conn,"COMMIT",*this);
+			break;
+		}
+	} catch (const Exception &e) {
+		error = e.clone();
+		resume();
+	}
+}
+
+void AsyncTrnStep::onResult(const Result &) {
+	switch (actions[pos-1]) {
+	case actRollback:
+		trn.needRollback = false;
+		if (op == actRollback) {
+			trn.state = AsyncTransaction::stRollbacked;
+			trn.delay = 0;
+		}
+		break;
+	case actStart:
+		trn.state = AsyncTransaction::stStarted;
+		break;
+	case actCommit:
+		trn.state = AsyncTransaction::stCommited;
+		trn.retryCount = 0;
+		break;
+	default:
+		break;
+	}
+	next();
+}
+
+void AsyncTrnStep::onError(const Exception &e) {
+	error = e.clone();
+	resume();
+}
+
+void AsyncTrnStep::onTimer() {
+	trn.delay = 0;
+	next();
+}
+
+bool AsyncTrnStep::await_resume() {
+	if (error != nil) error->throwAgain(THISLOCATION);
+	//transaction must not start with non-empty query buffer, see Transaction::start()
+	if (count && op == actStart) trn.queryObj.clear();
+	return count != 0;
+}
+
+AsyncTransaction::AsyncTransaction(AsyncReactor &reactor, Query &queryObj)
+	:reactor(reactor),queryObj(queryObj),conn(directConnection(queryObj.getConnection()))
+	,state(stReady),retryCount(0),delay(0),level(IConnection::defaultLevel),needRollback(false)
+{
+}
+
+AsyncTransaction::~AsyncTransaction() {
+	//destructor cannot suspend, so the rollback blocks the thread
+	if (state == stStarted || needRollback) try {
+		conn.rollbackTransaction();
+	} catch (...) {
+		//destructor must not throw
+	}
+}
+
+AsyncTrnStep AsyncTransaction::start(IConnection::Level isolationLevel) {
+	level = isolationLevel;
+	return AsyncTrnStep(*this,AsyncTrnStep::actStart);
+}
+
+AsyncTrnStep AsyncTransaction::commit() {
+	if (state == stReady) throw UnopenedTransactionException_t(THISLOCATION);
+	return AsyncTrnStep(*this,AsyncTrnStep::actCommit);
+}
+
+AsyncTrnStep AsyncTransaction::rollback() {
+	return AsyncTrnStep(*this,AsyncTrnStep::actRollback);
+}
+
+void AsyncTransaction::except(const ServerError_t &e, const ProgramLocation &loc) {
+	natural d = Transaction::recoveryDelay(conn,e,retryCount);
+	if (d != naturalNull) {
+		//rollback and delay are performed by the next start()
+		needRollback = needRollback || state == stStarted;
+		state = stRecovered;
+		delay = d;
+	} else {
+		LightSpeed::Exception::rethrow(loc);
+		throw;
+	}
+}
+
+void AsyncTransaction::reset() {
+	needRollback = needRollback || state == stStarted;
+	state = stReady;
+	delay = 0;
+	retryCount = 0;
+}
+
+Query& AsyncTransaction::operator()(ConstStrA queryText) {
+	if (state != stStarted) throw UnopenedTransactionException_t(THISLOCATION);
+	return queryObj(queryText);
+}
+
+Query& AsyncTransaction::operator()() {
+	if (state != stStarted) throw UnopenedTransactionException_t(THISLOCATION);
+	return queryObj;
+}
+
+}
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ * asyncCoro.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_ASYNCCORO_H_
+#define LIGHTMYSQL_ASYNCCORO_H_
+
+#include "asyncReactor.h"
+
+//coroutines need C++20 and the non-blocking client
+#if defined(LIGHTMYSQL_ASYNC) && defined(__cpp_impl_coroutine)
+#define LIGHTMYSQL_CORO 1
+
+#include <coroutine>
+#include <atomic>
+#include "query.h"
+#include "transaction.h"
+
+namespace LightMySQL {
+
+///Common part of the awaitable objects
+/**
+ * Operation can be completed before the coroutine is suspended (in the
+ * thread which started it) or later in the thread of the reactor. The flag
+ * is set by the side which comes second, that side is responsible to resume
+ * the coroutine
+ */
+class AsyncAwaiter {
+public:
+	AsyncAwaiter():flag(false) {}
+	bool await_ready() const {return false;}
+
+protected:
+	std::coroutine_handle<> handle;
+	std::atomic<bool> flag;
+
+	///Starts suspension
+	void beginSuspend(std::coroutine_handle<> h) {handle = h;}
+	///Finishes suspension
+	/**
+	 * @retval true coroutine is suspended
+	 * @retval false operation is already complete, coroutine continues
+	 */
+	bool endSuspend() {return !flag.exchange(true);}
+	///Called when operation is complete
+	void resume() {if (flag.exchange(true)) handle.resume();}
+
+private:
+	AsyncAwaiter(const AsyncAwaiter &other);
+	AsyncAwaiter &operator=(const AsyncAwaiter &other);
+};
+
+///Awaitable execution of the query
+/**
+ * @code
+ * Result res = co_await AsyncExec(reactor, conn, "SELECT 1");
+ * Result res = co_await q("SELECT %1").arg(1).execAsync(reactor);
+ * @endcode
+ *
+ * co_await returns Result or throws exception of the query
+ */
+class AsyncExec: public AsyncAwaiter, public IAsyncCompletion {
+public:
+	AsyncExec(AsyncReactor &reactor, Connection &conn, ConstStrA query)
+		:reactor(reactor),conn(conn),query(query) {}
+
+	bool await_suspend(std::coroutine_handle<> h) {
+		beginSuspend(h);
+		reactor.execute(conn,query,*this);
+		return endSuspend();
+	}
+	Result await_resume() {
+		if (error != nil) error->throwAgain(THISLOCATION);
+		Result &r = result;
+		return r;
+	}
+
+	virtual void onResult(const Result &res) {result = res;resume();}
+	virtual void onError(const Exception &e) {error = e.clone();resume();}
+
+protected:
+	AsyncReactor &reactor;
+	Connection &conn;
+	StringA query;
+	Optional<Result> result;
+	PException error;
+};
+
+///Suspends coroutine for given time
+/**
+ * @code
+ * co_await AsyncDelay(reactor, 100);
+ * @endcode
+ */
+class AsyncDelay: public AsyncAwaiter, public IAsyncTimer {
+public:
+	AsyncDelay(AsyncReactor &reactor, natural ms):reactor(reactor),ms(ms) {}
+
+	bool await_suspend(std::coroutine_handle<> h) {
+		beginSuspend(h);
+		reactor.schedule(ms,*this);
+		return endSuspend();
+	}
+	void await_resume() {}
+
+	virtual void onTimer() {resume();}
+
+protected:
+	AsyncReactor &reactor;
+	natural ms;
+};
+
+class AsyncTransaction;
+
+///Sequence of statements executed by the transaction (ROLLBACK, delay, START TRANSACTION, COMMIT)
+/** co_await returns true, if the sequence has been executed, or false, if there was nothing to do */
+class AsyncTrnStep: public AsyncAwaiter, public IAsyncCompletion, public IAsyncTimer {
+public:
+	enum Action {
+		///rollback failed transaction
+		actRollback,
+		///wait before the transaction is repeated
+		actDelay,
+		///set isolation level
+		actLevel,
+		///start transaction
+		actStart,
+		///commit transaction
+		actCommit
+	};
+
+	///Prepares the sequence
+	/**
+	 * @param trn transaction
+	 * @param op requested operation (actStart, actCommit or actRollback). Statements
+	 * are chosen by the state of the transaction
+	 */
+	AsyncTrnStep(AsyncTransaction &trn, Action op);
+
+	bool await_ready() const {return count == 0;}
+	bool await_suspend(std::coroutine_handle<> h) {
+		beginSuspend(h);
+		next();
+		return endSuspend();
+	}
+	bool await_resume();
+
+	virtual void onResult(const Result &res);
+	virtual void onError(const Exception &e);
+	virtual void onTimer();
+
+protected:
+	AsyncTransaction &trn;
+	Action op;
+	Action actions[4];
+	natural count;
+	natural pos;
+	PException error;
+
+	void next();
+};
+
+///Transaction which can be used from a coroutine
+/**
+ * Works similar to the Transaction, but all statements are executed
+ * through the AsyncReactor and the deadlock recovery suspends the coroutine
+ * instead of sleeping the thread. One thread can run thousands of transactions
+ *
+ * @code
+ * AsyncTransaction t(reactor, queryObj);
+ * while (co_await t.start()) try {
+ *     Result res = co_await t("SELECT ... FOR UPDATE").arg(id).execAsync(reactor);
+ *     t("UPDATE ...").arg(id);
+ *     co_await t.exec();
+ *     co_await t.commit();
+ * } catch (ServerError_t &e) {
+ *     t.except(e,THISLOCATION);
+ * }
+ * @endcode
+ *
+ * co_await is not allowed inside the catch handler, so except() only records
+ * the recovery. The rollback and the delay are performed by the next start()
+ *
+ * @note Connection of the query object must be a Connection, otherwise
+ * NoDirectConnectionException_t is thrown. Lifetime of
+ * the connection (ConnectParams::Lifetime) is not handled, connection must
+ * be connected.
+ */
+class AsyncTransaction {
+public:
+	AsyncTransaction(AsyncReactor &reactor, Query &queryObj);
+	~AsyncTransaction();
+
+	///Starts the transaction
+	/**
+	 * @param isolationLevel isolation level
+	 * @return awaitable object, co_await returns true, if the transaction has
+	 * been started, or false, if the transaction has been already committed
+	 */
+	AsyncTrnStep start(IConnection::Level isolationLevel = IConnection::defaultLevel);
+	///Commits the transaction
+	AsyncTrnStep commit();
+	///Rollbacks the transaction
+	/**
+	 * Rollbacks the started transaction. The transaction waiting for the
+	 * recovery (see except()) is rollbacked and it is not repeated, the next
+	 * start() returns false.
+	 *
+	 * @return awaitable object, co_await returns true, if the ROLLBACK has
+	 * been executed, or false, if there was no transaction
+	 */
+	AsyncTrnStep rollback();
+	///Handles the exception
+	/**
+	 * Must be called from the catch handler. If the error is a deadlock,
+	 * transaction is marked for repeating, otherwise exception is rethrown
+	 */
+	void except(const ServerError_t &e, const ProgramLocation &loc);
+	///Prepares the transaction to start again
+	void reset();
+
+	Query& operator()(ConstStrA queryText);
+	Query& operator()();
+	///Executes the prepared query
+	AsyncExec exec() {return (*this)().execAsync(reactor);}
+
+	AsyncReactor &getReactor() {return reactor;}
+
+protected:
+	friend class AsyncTrnStep;
+
+	enum State {
+		///transaction object is ready to start
+		stReady,
+		///transaction has been started
+		stStarted,
+		///transaction has been committed and cannot be started again
+		stCommited,
+		///transaction failed on deadlock, it must be rollbacked and repeated
+		stRecovered,
+		///transaction has been rollbacked
+		stRollbacked
+	};
+
+	AsyncReactor &reactor;
+	Query &queryObj;
+	Connection &conn;
+	State state;
+	natural retryCount;
+	///delay before the transaction is repeated
+	natural delay;
+	///isolation level of the starting transaction
+	IConnection::Level level;
+	///true, if the failed transaction must be rollbacked
+	bool needRollback;
+
+private:
+	AsyncTransaction(const AsyncTransaction &other);
+	AsyncTransaction &operator=(const AsyncTransaction &other);
+};
+
+}
+
+#endif
+
+#endif /* LIGHTMYSQL_ASYNCCORO_H_ */
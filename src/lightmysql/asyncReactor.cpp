@@ -0,0 +1,361 @@
+/*
+ * asyncReactor.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "asyncReactor.h"
+
+#ifdef LIGHTMYSQL_ASYNC
+
+#include "query.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <lightspeed/base/containers/autoArray.tcc>
+#include <lightspeed/base/sync/synchronize.h>
+#include <lightspeed/base/exceptions/systemException.h>
+
+namespace LightMySQL {
+
+static natural monotonicMs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return (natural)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+class AsyncReactor::AsyncOp {
+public:
+	enum State {
+		///executing the query
+		stQuery,
+		///storing the result
+		stStore,
+		///moving to the next result
+		stNext
+	};
+
+	Connection &conn;
+	MYSQL *mysql;
+	IAsyncCompletion &completion;
+	StringA query;
+	State state;
+	///true, if _start function of the current state has been called
+	bool started;
+	///true, if operation is waiting for an event
+	bool armed;
+	///true, if socket is registered in epoll
+	bool registered;
+	///time when the timeout expires (valid in the timed list only)
+	natural deadline;
+	///index in the table of operations
+	natural slot;
+	///value of armCounter, when the operation has been armed
+	uint32_t armSeq;
+	Result::ResultList_t results;
+
+	AsyncOp(Connection &conn, ConstStrA query, IAsyncCompletion &completion)
+		:conn(conn),mysql(&conn.conn),completion(completion),query(query)
+		,state(stQuery),started(false),armed(false),registered(false),deadline(0)
+		,slot(0),armSeq(0) {}
+};
+
+///data of the event of the wakefd
+static const uint64_t wakeEvent = ~(uint64_t)0;
+
+AsyncReactor::AsyncReactor():stopped(false),pending(0),armCounter(0) {
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (epfd == -1) throw ErrNoException(THISLOCATION,errno);
+	wakefd = eventfd(0,EFD_CLOEXEC|EFD_NONBLOCK);
+	if (wakefd == -1) {
+		int e = errno;
+		close(epfd);
+		throw ErrNoException(THISLOCATION,e);
+	}
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.u64 = wakeEvent;
+	epoll_ctl(epfd,EPOLL_CTL_ADD,wakefd,&ev);
+}
+
+AsyncReactor::~AsyncReactor() {
+	close(wakefd);
+	close(epfd);
+}
+
+void AsyncReactor::execute(Connection &conn, const Query &query, IAsyncCompletion &completion) {
+	execute(conn,query.build(),completion);
+}
+
+void AsyncReactor::execute(Connection &conn, ConstStrA query, IAsyncCompletion &completion) {
+	if (!conn.isConnected())
+		throw ServerError_t(THISLOCATION,2006,"mysql is disconnected");
+	conn.checkIdle(THISLOCATION);
+	bool enableNB;
+	AsyncOp *op;
+	{
+		Synchronized<FastLock> _(lock);
+		if (busy.find(&conn))
+			throw ServerError_t(THISLOCATION,2014,"Commands out of sync; connection is executing a query");
+		op = new AsyncOp(conn,query,completion);
+		natural slot = 0;
+		while (slot < ops.length() && ops[slot] != 0) slot++;
+		if (slot == ops.length()) ops.add(op);
+		else ops(slot) = op;
+		op->slot = slot;
+		busy.insert(&conn,true);
+		pending++;
+		//non-blocking mode is lost when the connection is reopened
+		enableNB = !conn.nonBlocking;
+		conn.nonBlocking = true;
+	}
+	if (enableNB) mysql_options(&conn.conn,MYSQL_OPT_NONBLOCK,0);
+	IDebugLog *log = conn.getLogObject();
+	if (log) log->onQueryExec(query);
+	step(op,0);
+}
+
+void AsyncReactor::step(AsyncOp *op, int readyStatus) {
+	MYSQL *m = op->mysql;
+	int status;
+	for(;;) {
+		switch (op->state) {
+		case AsyncOp::stQuery: {
+			int err = 0;
+			status = op->started?mysql_real_query_cont(&err,m,readyStatus)
+					:mysql_real_query_start(&err,m,op->query.data(),op->query.length());
+			op->started = true;
+			if (status) break;
+			if (err) {
+				failOp(op);
+				return;
+			}
+			op->state = AsyncOp::stStore;
+			op->started = false;
+			continue;
+		}
+		case AsyncOp::stStore: {
+			MYSQL_RES *res = 0;
+			status = op->started?mysql_store_result_cont(&res,m,readyStatus)
+					:mysql_store_result_start(&res,m);
+			op->started = true;
+			if (status) break;
+			if (res == 0 && mysql_errno(m)) {
+				failOp(op);
+				return;
+			}
+			op->results.push_back(Result::makeResultInfo(*m,res,op->conn.getLogObject()));
+			if (!mysql_more_results(m)) {
+				completeOp(op);
+				return;
+			}
+			op->state = AsyncOp::stNext;
+			op->started = false;
+			continue;
+		}
+		case AsyncOp::stNext: {
+			int ret = 0;
+			status = op->started?mysql_next_result_cont(&ret,m,readyStatus)
+					:mysql_next_result_start(&ret,m);
+			op->started = true;
+			if (status) break;
+			if (ret > 0) {
+				failOp(op);
+				return;
+			}
+			op->state = AsyncOp::stStore;
+			op->started = false;
+			continue;
+		}
+		}
+		waitOp(op,status);
+		return;
+	}
+}
+
+void AsyncReactor::waitOp(AsyncOp *op, int status) {
+	struct epoll_event ev;
+	ev.events = EPOLLONESHOT;
+	if (status & MYSQL_WAIT_READ) ev.events |= EPOLLIN;
+	if (status & MYSQL_WAIT_WRITE) ev.events |= EPOLLOUT;
+	if (status & MYSQL_WAIT_EXCEPT) ev.events |= EPOLLPRI;
+	{
+		Synchronized<FastLock> _(lock);
+		op->armed = true;
+		//events of the previous waiting are ignored
+		op->armSeq = ++armCounter;
+		ev.data.u64 = ((uint64_t)op->armSeq << 32) | op->slot;
+		if (status & MYSQL_WAIT_TIMEOUT) {
+			op->deadline = monotonicMs() + mysql_get_timeout_value_ms(op->mysql);
+			timed.add(op);
+		}
+	}
+	int fd = mysql_get_socket(op->mysql);
+	//operation can be processed by other thread once it is registered
+	bool reg = op->registered;
+	op->registered = true;
+	epoll_ctl(epfd,reg?EPOLL_CTL_MOD:EPOLL_CTL_ADD,fd,&ev);
+	//wake a thread to recalculate the timeout
+	if (status & MYSQL_WAIT_TIMEOUT) {
+		eventfd_t v = 1;
+		eventfd_write(wakefd,v);
+	}
+}
+
+AsyncReactor::AsyncOp *AsyncReactor::claimOp(uint64_t eventData) {
+	natural slot = (natural)(eventData & 0xFFFFFFFFU);
+	uint32_t seq = (uint32_t)(eventData >> 32);
+	Synchronized<FastLock> _(lock);
+	//operation can be already finished and deleted by other thread
+	if (slot >= ops.length()) return 0;
+	AsyncOp *op = ops[slot];
+	if (op == 0 || op->armSeq != seq || !op->armed) return 0;
+	op->armed = false;
+	for (natural i = 0; i < timed.length(); i++) {
+		if (timed[i] == op) {
+			timed.erase(i,1);
+			break;
+		}
+	}
+	return op;
+}
+
+void AsyncReactor::finishOp(AsyncOp *op) {
+	if (op->registered)
+		epoll_ctl(epfd,EPOLL_CTL_DEL,mysql_get_socket(op->mysql),0);
+	Synchronized<FastLock> _(lock);
+	//events of the operation, which are still being processed, are ignored from now
+	ops(op->slot) = 0;
+	busy.erase(&op->conn);
+	pending--;
+}
+
+void AsyncReactor::completeOp(AsyncOp *op) {
+	IAsyncCompletion &c = op->completion;
+	Result res(op->results);
+	finishOp(op);
+	delete op;
+	c.onResult(res);
+}
+
+void AsyncReactor::failOp(AsyncOp *op) {
+	IAsyncCompletion &c = op->completion;
+	Connection &conn = op->conn;
+	IDebugLog *log = conn.getLogObject();
+	if (log) log->onQueryError(mysql_error(op->mysql));
+	finishOp(op);
+	delete op;
+	//let the connection to handle the error (it closes the lost connection)
+	try {
+		conn.handleError(THISLOCATION);
+		throw ServerError_t(THISLOCATION,2000,"Unknown error");
+	} catch (const Exception &e) {
+		c.onError(e);
+	}
+}
+
+void AsyncReactor::schedule(natural ms, IAsyncTimer &timer) {
+	{
+		Synchronized<FastLock> _(lock);
+		timers.add(Timer(monotonicMs() + ms,&timer));
+	}
+	//wake a thread to recalculate the timeout
+	eventfd_t v = 1;
+	eventfd_write(wakefd,v);
+}
+
+int AsyncReactor::getTimeout(int timeout) {
+	Synchronized<FastLock> _(lock);
+	if (timed.empty() && timers.empty()) return timeout;
+	natural now = monotonicMs();
+	natural first = naturalNull;
+	for (natural i = 0; i < timed.length(); i++)
+		if (timed[i]->deadline < first) first = timed[i]->deadline;
+	for (natural i = 0; i < timers.length(); i++)
+		if (timers[i].deadline < first) first = timers[i].deadline;
+	int t = first > now?(int)(first - now):0;
+	if (timeout >= 0 && timeout < t) return timeout;
+	return t;
+}
+
+bool AsyncReactor::checkTimeouts() {
+	AutoArray<AsyncOp *> expired;
+	AutoArray<IAsyncTimer *> fired;
+	{
+		Synchronized<FastLock> _(lock);
+		natural now = monotonicMs();
+		natural i = 0;
+		while (i < timed.length()) {
+			AsyncOp *op = timed[i];
+			if (op->deadline <= now) {
+				op->armed = false;
+				timed.erase(i,1);
+				expired.add(op);
+			} else {
+				i++;
+			}
+		}
+		i = 0;
+		while (i < timers.length()) {
+			if (timers[i].deadline <= now) {
+				fired.add(timers[i].timer);
+				timers.erase(i,1);
+			} else {
+				i++;
+			}
+		}
+	}
+	for (natural i = 0; i < expired.length(); i++)
+		step(expired[i],MYSQL_WAIT_TIMEOUT);
+	for (natural i = 0; i < fired.length(); i++)
+		fired[i]->onTimer();
+	return !expired.empty() || !fired.empty();
+}
+
+bool AsyncReactor::runOnce(int timeout) {
+	if (stopped) return false;
+	struct epoll_event evs[16];
+	int cnt = epoll_wait(epfd,evs,16,getTimeout(timeout));
+	if (cnt < 0) {
+		if (errno == EINTR) return false;
+		throw ErrNoException(THISLOCATION,errno);
+	}
+	bool processed = false;
+	for (int i = 0; i < cnt; i++) {
+		if (evs[i].data.u64 == wakeEvent) {
+			if (stopped) return processed;
+			//wake up to recalculate timeout - consume the event
+			eventfd_t v;
+			eventfd_read(wakefd,&v);
+			continue;
+		}
+		AsyncOp *op = claimOp(evs[i].data.u64);
+		if (op == 0) continue;
+		int ready = 0;
+		if (evs[i].events & (EPOLLIN|EPOLLHUP|EPOLLERR)) ready |= MYSQL_WAIT_READ;
+		if (evs[i].events & EPOLLOUT) ready |= MYSQL_WAIT_WRITE;
+		if (evs[i].events & EPOLLPRI) ready |= MYSQL_WAIT_EXCEPT;
+		step(op,ready);
+		processed = true;
+	}
+	if (checkTimeouts()) processed = true;
+	return processed;
+}
+
+void AsyncReactor::run() {
+	while (!stopped) runOnce(-1);
+}
+
+void AsyncReactor::stop() {
+	stopped = true;
+	//eventfd is not read when stopped, so it wakes all threads
+	eventfd_t v = 1;
+	eventfd_write(wakefd,v);
+}
+
+}
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * asyncReactor.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_ASYNCREACTOR_H_
+#define LIGHTMYSQL_ASYNCREACTOR_H_
+
+#include <mysql/mysql.h>
+
+//non-blocking API is available in MariaDB Connector/C only, the reactor needs C++11 atomics
+#if defined(LIBMARIADB) && defined(__linux__) && __cplusplus >= 201103L
+#define LIGHTMYSQL_ASYNC 1
+
+#include <atomic>
+#include <stdint.h>
+#include <lightspeed/base/actions/promise.h>
+#include <lightspeed/base/containers/map.h>
+#include <lightspeed/mt/fastlock.h>
+#include "connection.h"
+#include "result.h"
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+class Query;
+
+///Receives result of the asynchronous query
+class IAsyncCompletion {
+public:
+	///Query has been executed
+	/** @param res result of the query */
+	virtual void onResult(const Result &res) = 0;
+	///Query failed
+	/** @param e exception describing the error */
+	virtual void onError(const Exception &e) = 0;
+	virtual ~IAsyncCompletion() {}
+};
+
+///Receives notification from the timer
+class IAsyncTimer {
+public:
+	///Timer expired
+	virtual void onTimer() = 0;
+	virtual ~IAsyncTimer() {}
+};
+
+///Completion which resolves the promise
+/** Object deletes itself after the completion
+ *
+ * @code
+ * reactor.execute(conn,query,*new PromiseCompletion(promiseResult));
+ * @endcode
+ */
+class PromiseCompletion: public IAsyncCompletion {
+public:
+	PromiseCompletion(const Promise<Result>::Result &result):result(result) {}
+	virtual void onResult(const Result &res) {result.resolve(res);delete this;}
+	virtual void onError(const Exception &e) {result.reject(e);delete this;}
+protected:
+	Promise<Result>::Result result;
+};
+
+///Executes queries asynchronously using an epoll event loop
+/**
+ * Queries are executed using non-blocking API of the MariaDB Connector/C.
+ * While the query waits for the server, the thread is not blocked. One
+ * or few threads calling run() can serve hundreds of connections.
+ *
+ * @code
+ * AsyncReactor reactor;
+ * //thread(s)
+ * reactor.run();
+ *
+ * //anywhere
+ * Query q(conn);
+ * reactor.execute(conn, q("SELECT * FROM users WHERE id=%1").arg(id), completion);
+ * @endcode
+ *
+ * Completion is called in the thread running run() (or in the thread
+ * calling execute(), when the query is finished without waiting).
+ *
+ * @note Connection cannot be used by other code until the query is completed.
+ * Client timeouts (MYSQL_OPT_READ_TIMEOUT) are handled by the reactor.
+ */
+class AsyncReactor {
+public:
+	AsyncReactor();
+	~AsyncReactor();
+
+	///Executes query asynchronously
+	/**
+	 * @param conn connection, must be connected
+	 * @param query text of the query
+	 * @param completion object which receives the result. It must remain
+	 * valid until it is called
+	 * @exception ServerError_t connection is not connected or it is already executing a query
+	 */
+	void execute(Connection &conn, ConstStrA query, IAsyncCompletion &completion);
+	///Executes query asynchronously
+	/**
+	 * @param conn connection, must be connected
+	 * @param query query to build. Object can be reused after the function returns
+	 * @param completion object which receives the result
+	 */
+	void execute(Connection &conn, const Query &query, IAsyncCompletion &completion);
+
+	///Schedules the timer
+	/**
+	 * @param ms delay in milliseconds
+	 * @param timer object notified after the delay. It is called by the
+	 * thread running run(). Object must remain valid until it is called
+	 */
+	void schedule(natural ms, IAsyncTimer &timer);
+
+	///Processes events until stop() is called
+	/** Function can be called by multiple threads */
+	void run();
+	///Processes events
+	/**
+	 * @param timeout timeout in milliseconds, -1 infinite
+	 * @retval true some event has been processed
+	 * @retval false timeout or stop() has been called
+	 */
+	bool runOnce(int timeout);
+	///Stops all threads in run()
+	void stop();
+
+	///Retrieves count of queries in progress
+	natural getPendingCount() const {return pending.load();}
+
+protected:
+
+	class AsyncOp;
+
+	///epoll file descriptor
+	int epfd;
+	///eventfd used to wake up threads
+	int wakefd;
+	std::atomic<bool> stopped;
+	std::atomic<natural> pending;
+	///connections executing a query
+	Map<const Connection *, bool> busy;
+	///operations in progress, index of the slot is stored in the epoll event
+	/** Event doesn't carry the pointer, because the operation can be finished
+	 * and deleted by other thread, while the event is still being processed */
+	AutoArray<AsyncOp *> ops;
+	///increased every time an operation starts to wait, identifies the event
+	uint32_t armCounter;
+	///operations waiting with a timeout
+	AutoArray<AsyncOp *> timed;
+
+	struct Timer {
+		natural deadline;
+		IAsyncTimer *timer;
+		Timer(natural deadline, IAsyncTimer *timer):deadline(deadline),timer(timer) {}
+	};
+	///scheduled timers
+	AutoArray<Timer> timers;
+	FastLock lock;
+
+	void step(AsyncOp *op, int readyStatus);
+	void waitOp(AsyncOp *op, int waitStatus);
+	AsyncOp *claimOp(uint64_t eventData);
+	void finishOp(AsyncOp *op);
+	void completeOp(AsyncOp *op);
+	void failOp(AsyncOp *op);
+	bool checkTimeouts();
+	int getTimeout(int timeout);
+
+private:
+	AsyncReactor(const AsyncReactor &other);
+	AsyncReactor &operator=(const AsyncReactor &other);
+};
+
+}
+
+#endif
+
+#endif /* LIGHTMYSQL_ASYNCREACTOR_H_ */
@@ -0,0 +1,105 @@
+/*
+ * bulkInserter.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "bulkInserter.h"
+#include "result.h"
+#include <lightspeed/base/containers/autoArray.tcc>
+#include <stdio.h>
+#include <ctype.h>
+
+namespace LightMySQL {
+
+///bytes reserved for the packet header and the command
+static const natural packetReserve = 1024;
+
+BulkInserter::BulkInserter(IConnection &conn, ConstStrA table, ConstStrA columns,
+		ConstStrA onDuplicate, bool ignore)
+	:conn(conn),rowQuery(conn),columnCount(0),fedColumns(0),pendingRows(0)
+	,maxRows(defaultMaxRows),maxPacket(0),affected(0),insertedRows(0)
+{
+	Query hdr(conn);
+	hdr(ignore?"INSERT IGNORE INTO %1 (":"INSERT INTO %1 (").field(table);
+	AutoArray<char> rowPat;
+	rowPat.add('(');
+	for (ConstStrA::SplitIterator iter = columns.split(','); iter.hasItems();) {
+		ConstStrA col = iter.getNext();
+		while (!col.empty() && isspace(col[0])) col = col.crop(1,0);
+		while (!col.empty() && isspace(col[col.length()-1])) col = col.crop(0,1);
+		if (col.empty()) continue;
+		if (columnCount) {
+			hdr.append(",%1").field(col);
+			rowPat.add(',');
+		} else {
+			hdr.append("%1").field(col);
+		}
+		columnCount++;
+		char buff[32];
+		int len = snprintf(buff,sizeof(buff),"%%%lu",(unsigned long)columnCount);
+		rowPat.append(ConstStrA(buff,len));
+	}
+	rowPat.add(')');
+	hdr.append(") VALUES ");
+	header.append(hdr.build());
+	if (!onDuplicate.empty()) {
+		footer.append(ConstStrA(" ON DUPLICATE KEY UPDATE "));
+		footer.append(onDuplicate);
+	}
+	rowPattern.compile(rowPat);
+	rowQuery(rowPattern);
+}
+
+BulkInserter &BulkInserter::nextColumn() {
+	if (++fedColumns == columnCount) endRow();
+	return *this;
+}
+
+void BulkInserter::endRow() {
+	ConstStrA row = rowQuery.build();
+	fedColumns = 0;
+	natural limit = getMaxPacket();
+	if (pendingRows
+			&& statement.length() + 1 + row.length() + footer.length() > limit)
+		flush();
+	if (pendingRows == 0) {
+		statement.clear();
+		statement.append(header);
+	} else {
+		statement.add(',');
+	}
+	statement.append(row);
+	rowQuery.clearArgs();
+	pendingRows++;
+	if (pendingRows >= maxRows) flush();
+}
+
+natural BulkInserter::getMaxPacket() {
+	if (maxPacket == 0) {
+		Result res = conn.executeQuery("SELECT @@max_allowed_packet");
+		natural v = 0;
+		if (res.hasItems()) v = res.getNext()[0].as<natural>();
+		maxPacket = v > 2 * packetReserve?v - packetReserve:packetReserve;
+	}
+	return maxPacket;
+}
+
+natural BulkInserter::flush() {
+	if (fedColumns)
+		throw UnassignedQueryParameterException_t(THISLOCATION,rowPattern.getPattern(),fedColumns+1);
+	if (pendingRows == 0) return 0;
+	statement.append(footer);
+	natural rows = pendingRows;
+	//rows are discarded even if the execution fails
+	pendingRows = 0;
+	Result res = conn.executeQuery(statement);
+	my_ulonglong aff = res.getAffectedRows();
+	affected += aff;
+	insertedRows += rows;
+	chunks.add(Chunk(rows,aff,res.getInsertId()));
+	return rows;
+}
+
+}
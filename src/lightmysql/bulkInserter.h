@@ -0,0 +1,152 @@
+/*
+ * bulkInserter.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_BULKINSERTER_H_
+#define LIGHTMYSQL_BULKINSERTER_H_
+
+#include "query.h"
+#include "compiledQuery.h"
+#include <lightspeed/base/containers/autoArray.h>
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+///Inserts many rows using multi-row INSERT statements
+/**
+ * Rows are fed through the arg() functions the same way as arguments of the Query.
+ * When all columns of the row are fed, the row is encoded and appended
+ * to the statement. The statement is executed when it reaches the size
+ * of max_allowed_packet or the maximum count of rows. Don't forget to
+ * call flush() after the last row.
+ *
+ * @code
+ * BulkInserter ins(conn,"users","id,name,email","name=VALUES(name)");
+ * for (...) ins << id << name << email;
+ * ins.flush();
+ * @endcode
+ *
+ * @note Each flushed chunk is executed as a separate statement. Use
+ * a transaction if all rows must be inserted atomically.
+ */
+class BulkInserter {
+public:
+
+	///Result of one executed statement
+	struct Chunk {
+		///count of rows in the statement
+		natural rows;
+		///affected rows reported by the server
+		my_ulonglong affected;
+		///insert id (id of the first inserted row of the chunk)
+		my_ulonglong insertId;
+
+		Chunk(natural rows, my_ulonglong affected, my_ulonglong insertId)
+			:rows(rows),affected(affected),insertId(insertId) {}
+	};
+
+	///default maximum count of rows in the single statement
+	static const natural defaultMaxRows = 10000;
+
+	///Constructs inserter
+	/**
+	 * @param conn connection
+	 * @param table name of the table
+	 * @param columns names of the columns separated by comma
+	 * @param onDuplicate optional expression of ON DUPLICATE KEY UPDATE
+	 *  clause (without the keywords). Text is used as is.
+	 * @param ignore use INSERT IGNORE
+	 */
+	BulkInserter(IConnection &conn, ConstStrA table, ConstStrA columns,
+			ConstStrA onDuplicate = ConstStrA(), bool ignore = false);
+	///Destructor
+	/** Rows which has not been flushed are discarded */
+	~BulkInserter() {}
+
+	///feed by argument - see Query::arg()
+	template<typename T>
+	BulkInserter &arg(const T &v) {rowQuery.arg(v);return nextColumn();}
+	///feed by NULL
+	BulkInserter &null() {rowQuery.null();return nextColumn();}
+	///feed by NOW()
+	BulkInserter &now() {rowQuery.now();return nextColumn();}
+	///feed by raw text
+	BulkInserter &raw(ConstStrA text) {rowQuery.raw(text);return nextColumn();}
+	///Depends on first argument, function supplies specified value or NULL
+	template<typename T>
+	BulkInserter &arg_null(bool notnull, const T &val) {
+		if (notnull) return arg(val);
+		else return null();
+	}
+	///feed by operator <<
+	template<typename T>
+	BulkInserter &operator << (const T &v) {return arg(v);}
+
+	///Executes pending rows
+	/**
+	 * @return count of executed rows
+	 * @exception UnassignedQueryParameterException_t last row is not complete
+	 */
+	natural flush();
+
+	///Sets maximum count of rows in the single statement
+	void setMaxRows(natural rows) {maxRows = rows;}
+	///Sets maximum size of the statement
+	/**
+	 * @param bytes maximum size in bytes. Default value is read from the
+	 * server's max_allowed_packet when the first row is added
+	 */
+	void setMaxPacket(natural bytes) {maxPacket = bytes;}
+
+	///Retrieves count of rows waiting to flush
+	natural getPendingRows() const {return pendingRows;}
+	///Retrieves sum of affected rows of all executed statements
+	my_ulonglong getAffectedRows() const {return affected;}
+	///Retrieves count of rows sent to the server
+	natural getInsertedRows() const {return insertedRows;}
+	///Retrieves results of all executed statements
+	ConstStringT<Chunk> getChunks() const {return chunks;}
+	///Clears results of executed statements
+	void clearChunks() {chunks.clear();}
+
+protected:
+
+	IConnection &conn;
+	///encodes single row
+	Query rowQuery;
+	///pattern of the row - (%1,%2,...)
+	CompiledQuery rowPattern;
+	///"INSERT INTO table (columns) VALUES "
+	AutoArray<char> header;
+	///" ON DUPLICATE KEY UPDATE ..."
+	AutoArray<char> footer;
+	///statement being built
+	AutoArray<char> statement;
+
+	natural columnCount;
+	natural fedColumns;
+	natural pendingRows;
+	natural maxRows;
+	///maximum size of statement, 0 - read from server
+	natural maxPacket;
+
+	my_ulonglong affected;
+	natural insertedRows;
+	AutoArray<Chunk> chunks;
+
+	BulkInserter &nextColumn();
+	void endRow();
+	natural getMaxPacket();
+
+private:
+	BulkInserter(const BulkInserter &other);
+	BulkInserter &operator=(const BulkInserter &other);
+};
+
+}
+
+#endif /* LIGHTMYSQL_BULKINSERTER_H_ */
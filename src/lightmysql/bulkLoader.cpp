@@ -0,0 +1,240 @@
+/*
+ * bulkLoader.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "bulkLoader.h"
+#include "query.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include "mysql/errmsg.h"
+#include <lightspeed/base/containers/autoArray.tcc>
+#include <lightspeed/base/memory/smallAlloc.h>
+#include <lightspeed/base/streams/utf.h>
+#include <lightspeed/base/streams/utf.tcc>
+
+namespace LightMySQL {
+
+///data are sent to the server in blocks, source is asked for more rows until the block is filled
+static const natural minBlockSize = 65536;
+
+BulkLoader::LocalInfileGuard::LocalInfileGuard(MYSQL &sql, BulkLoader *owner):sql(sql) {
+	unsigned int enable = 1;
+	mysql_options(&sql,MYSQL_OPT_LOCAL_INFILE,&enable);
+	mysql_set_local_infile_handler(&sql,&infileInit,&infileRead,&infileEnd,&infileError,owner);
+}
+
+BulkLoader::LocalInfileGuard::~LocalInfileGuard() {
+	//the default handler reads files of the client, so LOCAL INFILE must be disabled
+	//before it is restored. Otherwise the server could request any file
+	unsigned int disable = 0;
+	mysql_options(&sql,MYSQL_OPT_LOCAL_INFILE,&disable);
+	mysql_set_local_infile_default(&sql);
+}
+
+BulkLoader::BulkLoader(Connection &conn)
+	:conn(conn),source(0),readPos(0),fieldCount(0),sentRows(0),eof(false)
+{
+}
+
+BulkLoader::~BulkLoader() {
+}
+
+Result BulkLoader::load(ConstStrA table, ConstStrA columns, IBulkSource &source, DupMode dupMode) {
+	static const char *dupModes[] = {""," REPLACE"," IGNORE"};
+
+	Query q(conn);
+	q("LOAD DATA LOCAL INFILE 'stream'%1 INTO TABLE %2 CHARACTER SET utf8mb4 "
+			"FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n'")
+			.raw(dupModes[dupMode]).field(table);
+	if (!columns.empty()) {
+		bool first = true;
+		for (ConstStrA::SplitIterator iter = columns.split(','); iter.hasItems();) {
+			ConstStrA col = iter.getNext();
+			while (!col.empty() && isspace(col[0])) col = col.crop(1,0);
+			while (!col.empty() && isspace(col[col.length()-1])) col = col.crop(0,1);
+			if (col.empty()) continue;
+			q.append(first?" (%1":",%1").field(col);
+			first = false;
+		}
+		if (!first) q.append(")");
+	}
+	ConstStrA stmt = q.build();
+
+	this->source = &source;
+	buffer.clear();
+	readPos = 0;
+	fieldCount = 0;
+	sentRows = 0;
+	eof = false;
+	error = nil;
+	errorMsg = StringA();
+
+	LocalInfileGuard guard(conn.conn,this);
+	try {
+		Result res = conn.executeQuery(stmt);
+		this->source = 0;
+		return res;
+	} catch (...) {
+		this->source = 0;
+		//report the exception of the source instead of the server's error
+		if (error != nil) {
+			PException e = error;
+			error = nil;
+			e->throwAgain(THISLOCATION);
+		}
+		throw;
+	}
+}
+
+int BulkLoader::infileInit(void **ptr, const char *, void *userdata) {
+	*ptr = userdata;
+	return 0;
+}
+
+int BulkLoader::infileRead(void *ptr, char *buf, unsigned int buf_len) {
+	return reinterpret_cast<BulkLoader *>(ptr)->read(buf,buf_len);
+}
+
+void BulkLoader::infileEnd(void *) {
+}
+
+int BulkLoader::infileError(void *ptr, char *error_msg, unsigned int error_msg_len) {
+	BulkLoader *me = reinterpret_cast<BulkLoader *>(ptr);
+	if (error_msg_len) {
+		natural l = me->errorMsg.length();
+		if (l >= error_msg_len) l = error_msg_len - 1;
+		memcpy(error_msg,me->errorMsg.data(),l);
+		error_msg[l] = 0;
+	}
+	return CR_UNKNOWN_ERROR;
+}
+
+int BulkLoader::read(char *buf, unsigned int len) {
+	//exceptions must not pass through the client library
+	try {
+		natural avail = buffer.length() - readPos;
+		if (avail < len && !eof) {
+			//move unsent data to the beginning and generate more rows
+			buffer.erase(0,readPos);
+			readPos = 0;
+			natural want = len < minBlockSize?minBlockSize:len;
+			while (buffer.length() < want) {
+				if (!source->fetchRow(*this)) {
+					eof = true;
+					break;
+				}
+				buffer.add('\n');
+				fieldCount = 0;
+				sentRows++;
+			}
+			avail = buffer.length();
+		}
+		if (avail > len) avail = len;
+		memcpy(buf,buffer.data() + readPos,avail);
+		readPos += avail;
+		return (int)avail;
+	} catch (const Exception &e) {
+		error = e.clone();
+		errorMsg = e.what();
+		return -1;
+	} catch (const std::exception &e) {
+		errorMsg = e.what();
+		return -1;
+	} catch (...) {
+		errorMsg = "Unknown exception in the source of rows";
+		return -1;
+	}
+}
+
+void BulkLoader::beginField() {
+	if (fieldCount) buffer.add('\t');
+	fieldCount++;
+}
+
+void BulkLoader::writeEscaped(const char *data, natural length) {
+	const char *e = data + length;
+	while (data != e) {
+		//find longest run which doesn't need escaping
+		const char *p = data;
+		while (p != e && *p != '\\' && *p != '\t' && *p != '\n' && *p != '\r' && *p != 0) ++p;
+		buffer.append(ConstStrA(data,p - data));
+		if (p == e) break;
+		buffer.add('\\');
+		switch (*p) {
+		case '\t': buffer.add('t');break;
+		case '\n': buffer.add('n');break;
+		case '\r': buffer.add('r');break;
+		case 0: buffer.add('0');break;
+		default: buffer.add(*p);break;
+		}
+		data = p + 1;
+	}
+}
+
+void BulkLoader::writeNumber(const char *fmt, ...) {
+	char buff[64];
+	va_list args;
+	va_start(args,fmt);
+	int len = vsnprintf(buff,sizeof(buff),fmt,args);
+	va_end(args);
+	beginField();
+	buffer.append(ConstStrA(buff,len));
+}
+
+BulkLoader &BulkLoader::arg(ConstStrA str) {
+	beginField();
+	writeEscaped(str.data(),str.length());
+	return *this;
+}
+
+BulkLoader &BulkLoader::arg(ConstStrW str) {
+	AutoArray<char,SmallAlloc<256> > buff;
+	WideToUtf8Reader<ConstStrW::Iterator> iter(str.getFwIter());
+	while (iter.hasItems()) {
+		buff.add(iter.getNext());
+	}
+	return arg(ConstStrA(buff));
+}
+
+BulkLoader &BulkLoader::arg(ConstBin str) {
+	beginField();
+	writeEscaped(reinterpret_cast<const char *>(str.data()),str.length());
+	return *this;
+}
+
+BulkLoader &BulkLoader::arg(int i) {writeNumber("%d",i);return *this;}
+BulkLoader &BulkLoader::arg(unsigned int i) {writeNumber("%u",i);return *this;}
+BulkLoader &BulkLoader::arg(long i) {writeNumber("%ld",i);return *this;}
+BulkLoader &BulkLoader::arg(unsigned long i) {writeNumber("%lu",i);return *this;}
+BulkLoader &BulkLoader::arg(long long i) {writeNumber("%lld",i);return *this;}
+BulkLoader &BulkLoader::arg(unsigned long long i) {writeNumber("%llu",i);return *this;}
+BulkLoader &BulkLoader::arg(double val) {writeNumber("%.17g",val);return *this;}
+
+BulkLoader &BulkLoader::arg(const TimeStamp &val) {
+	StringA txt = val.formatTime(ConstStrA("%Y-%m-%d %H:%M:%S"));
+	return arg(ConstStrA(txt));
+}
+
+BulkLoader &BulkLoader::null() {
+	beginField();
+	buffer.append(ConstStrA("\\N"));
+	return *this;
+}
+
+bool ResultBulkSource::fetchRow(BulkLoader &loader) {
+	if (!res.hasItems()) return false;
+	Row rw = res.getNext();
+	for (natural i = 0; i < rw.size(); i++) {
+		FieldContent f = rw[i];
+		if (f.isNull()) loader.null();
+		else loader.arg(f.as<ConstBin>());
+	}
+	return true;
+}
+
+}
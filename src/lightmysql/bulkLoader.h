@@ -0,0 +1,199 @@
+/*
+ * bulkLoader.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_BULKLOADER_H_
+#define LIGHTMYSQL_BULKLOADER_H_
+
+#include <lightspeed/base/containers/autoArray.h>
+#include <lightspeed/base/timestamp.h>
+#include "connection.h"
+#include "result.h"
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+class BulkLoader;
+
+///Source of rows for the BulkLoader
+class IBulkSource {
+public:
+	///Writes next row
+	/**
+	 * @param loader loader. Write fields of the row using arg() and null()
+	 * @retval true row has been written
+	 * @retval false no more rows
+	 */
+	virtual bool fetchRow(BulkLoader &loader) = 0;
+	virtual ~IBulkSource() {}
+};
+
+///Loads rows using LOAD DATA LOCAL INFILE
+/**
+ * Rows are generated by the IBulkSource while the server reads the
+ * "file". They are encoded to the tab-separated form and sent directly
+ * to the server, no temporary file is created.
+ *
+ * @code
+ * class Source: public IBulkSource {
+ *     virtual bool fetchRow(BulkLoader &loader) {
+ *        if (!hasData()) return false;
+ *        loader << id << name << email;
+ *        return true;
+ *     }
+ * };
+ * BulkLoader loader(conn);
+ * Source src;
+ * Result res = loader.load("users","id,name,email",src);
+ * @endcode
+ *
+ * @note Connection must allow local files. Open it with flag CLIENT_LOCAL_FILES,
+ * and the server must have local_infile enabled
+ */
+class BulkLoader {
+public:
+
+	///How to handle rows with duplicate key
+	enum DupMode {
+		///default - for LOCAL loading it is the same as dupIgnore
+		dupDefault,
+		///replace existing rows
+		dupReplace,
+		///skip duplicate rows
+		dupIgnore
+	};
+
+	///Constructs the loader
+	/**
+	 * @param conn connection
+	 */
+	BulkLoader(Connection &conn);
+	~BulkLoader();
+
+	///Loads rows into the table
+	/**
+	 * @param table name of the table
+	 * @param columns names of columns separated by comma. If empty, all
+	 * columns of the table are loaded
+	 * @param source source of rows
+	 * @param dupMode handling of duplicate keys
+	 * @return result of LOAD DATA. Use getAffectedRows() to retrieve count
+	 * of loaded rows. Result (including warnings) is also reported to the log object
+	 * @exception any exception thrown by the source is thrown again
+	 */
+	Result load(ConstStrA table, ConstStrA columns, IBulkSource &source,
+			DupMode dupMode = dupDefault);
+
+	///Retrieves count of rows generated during last load()
+	natural getSentRows() const {return sentRows;}
+
+	///write field
+	BulkLoader &arg(ConstStrA str);
+	///write field
+	BulkLoader &arg(ConstStrW str);
+	///write field
+	BulkLoader &arg(ConstBin str);
+	///write field
+	BulkLoader &arg(int i);
+	///write field
+	BulkLoader &arg(unsigned int i);
+	///write field
+	BulkLoader &arg(long i);
+	///write field
+	BulkLoader &arg(unsigned long i);
+	///write field
+	BulkLoader &arg(long long i);
+	///write field
+	BulkLoader &arg(unsigned long long i);
+	///write field
+	BulkLoader &arg(double val);
+	///write field - date and time
+	BulkLoader &arg(const TimeStamp &val);
+	///write NULL
+	BulkLoader &null();
+
+	///write field
+	template<typename T>
+	BulkLoader &operator << (const T &v) {return arg(v);}
+
+	///Depends on first argument, function writes specified value or NULL
+	template<typename T>
+	BulkLoader &arg_null(bool notnull, const T &val) {
+		if (notnull) return arg(val);
+		else return null();
+	}
+
+protected:
+
+	Connection &conn;
+	IBulkSource *source;
+	///encoded rows waiting to send
+	AutoArray<char> buffer;
+	///position of unsent data in the buffer
+	natural readPos;
+	///count of fields in the current row
+	natural fieldCount;
+	natural sentRows;
+	bool eof;
+	///exception thrown by the source
+	PException error;
+	///message reported to the client library
+	StringA errorMsg;
+
+	void beginField();
+	void writeEscaped(const char *data, natural length);
+	void writeNumber(const char *fmt, ...);
+	int read(char *buf, unsigned int len);
+
+	static int infileInit(void **ptr, const char *filename, void *userdata);
+	static int infileRead(void *ptr, char *buf, unsigned int buf_len);
+	static void infileEnd(void *ptr);
+	static int infileError(void *ptr, char *error_msg, unsigned int error_msg_len);
+
+	///Enables LOCAL INFILE with the handlers of the loader, disables it on destruction
+	class LocalInfileGuard {
+	public:
+		LocalInfileGuard(MYSQL &sql, BulkLoader *owner);
+		~LocalInfileGuard();
+	protected:
+		MYSQL &sql;
+	private:
+		LocalInfileGuard(const LocalInfileGuard &other);
+		LocalInfileGuard &operator=(const LocalInfileGuard &other);
+	};
+
+private:
+	BulkLoader(const BulkLoader &other);
+	BulkLoader &operator=(const BulkLoader &other);
+};
+
+///Source of rows which copies rows of the Result
+/** Allows to copy result of the query into another table (or another server) */
+class ResultBulkSource: public IBulkSource {
+public:
+	ResultBulkSource(Result &res):res(res) {}
+	virtual bool fetchRow(BulkLoader &loader);
+protected:
+	Result &res;
+};
+
+///Source of rows which calls a function
+/**
+ * @tparam Fn function or function object with prototype bool fn(BulkLoader &)
+ */
+template<typename Fn>
+class FunctionBulkSource: public IBulkSource {
+public:
+	FunctionBulkSource(Fn fn):fn(fn) {}
+	virtual bool fetchRow(BulkLoader &loader) {return fn(loader);}
+protected:
+	Fn fn;
+};
+
+}
+
+#endif /* LIGHTMYSQL_BULKLOADER_H_ */
@@ -0,0 +1,120 @@
+/*
+ * columnarResult.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "columnarResult.h"
+#include "numberParse.h"
+#include <lightspeed/base/containers/autoArray.tcc>
+#include <lightspeed/base/exceptions/throws.tcc>
+
+namespace LightMySQL {
+
+ColumnarResult::ColumnarResult(Result &res):rows(0) {
+	load(res);
+}
+
+ColumnarResult::ColumnType ColumnarResult::getColumnType(const MYSQL_FIELD *field) {
+	switch (field->type) {
+	case MYSQL_TYPE_TINY:
+	case MYSQL_TYPE_SHORT:
+	case MYSQL_TYPE_INT24:
+	case MYSQL_TYPE_LONG:
+	case MYSQL_TYPE_YEAR:
+		return colInt;
+	case MYSQL_TYPE_LONGLONG:
+		return (field->flags & UNSIGNED_FLAG)?colUInt:colInt;
+	case MYSQL_TYPE_FLOAT:
+	case MYSQL_TYPE_DOUBLE:
+	case MYSQL_TYPE_DECIMAL:
+	case MYSQL_TYPE_NEWDECIMAL:
+		return colDouble;
+	default:
+		return colText;
+	}
+}
+
+void ColumnarResult::Column::setNull(natural row) {
+	natural byte = row >> 3;
+	while (nulls.length() <= byte) nulls.add(0);
+	nulls(byte) |= (unsigned char)(1 << (row & 7));
+	nullCount++;
+}
+
+void ColumnarResult::load(Result &res) {
+	natural cnt = res.countFields();
+	columns.resize(cnt);
+	for (natural i = 0; i < cnt; i++) {
+		const MYSQL_FIELD *f = res.getFieldInfo(i);
+		Column &c = columns(i);
+		c.name = ConstStrA(f->name,f->name_length);
+		c.type = getColumnType(f);
+		if (c.type == colText) c.offsets.add(0);
+	}
+
+	res.rewind();
+	MYSQL_ROW row;
+	const unsigned long *lengths;
+	const NativeField *natives;
+	while (res.takeRow(row,lengths,natives)) {
+		for (natural i = 0; i < cnt; i++) {
+			Column &c = columns(i);
+			const char *v = row[i];
+			if (v == 0) {
+				c.setNull(rows);
+				switch (c.type) {
+				case colInt: c.ints.add(0);break;
+				case colUInt: c.uints.add(0);break;
+				case colDouble: c.doubles.add(0);break;
+				case colText: c.offsets.add(c.arena.length());break;
+				}
+				continue;
+			}
+			const NativeField *n = natives && natives[i].type != NativeField::typeText?natives + i:0;
+			switch (c.type) {
+			case colInt:
+				if (n && n->type == NativeField::typeInt) c.ints.add(n->value.i);
+				else if (n && n->type == NativeField::typeUInt) c.ints.add((long long)n->value.u);
+				else c.ints.add(parseIntField<long long>(ConstStrA(v,lengths[i])));
+				break;
+			case colUInt:
+				if (n && n->type == NativeField::typeUInt) c.uints.add(n->value.u);
+				else c.uints.add(parseIntField<unsigned long long>(ConstStrA(v,lengths[i])));
+				break;
+			case colDouble:
+				if (n && n->type == NativeField::typeDouble) c.doubles.add(n->value.d);
+				else if (n && n->type == NativeField::typeFloat) c.doubles.add(n->value.f);
+				else c.doubles.add(parseFloatField<double>(ConstStrA(v,lengths[i])));
+				break;
+			case colText: {
+				ConstStrA txt = n?n->getText():ConstStrA(v,lengths[i]);
+				c.arena.append(txt);
+				c.offsets.add(c.arena.length());
+				break;
+			}
+			}
+		}
+		rows++;
+	}
+	//bitmap covers all rows
+	for (natural i = 0; i < cnt; i++) {
+		Column &c = columns(i);
+		if (c.nullCount) while (c.nulls.length() < (rows + 7) >> 3) c.nulls.add(0);
+	}
+}
+
+const ColumnarResult::Column &ColumnarResult::operator[](natural index) const {
+	if (index >= columns.length())
+		throwRangeException_FromTo(THISLOCATION,0,(int)columns.length()-1,(int)index);
+	return columns[index];
+}
+
+const ColumnarResult::Column &ColumnarResult::operator[](ConstStrA name) const {
+	for (natural i = 0; i < columns.length(); i++)
+		if (ConstStrA(columns[i].name) == name) return columns[i];
+	throw FieldNotFoundException_t(THISLOCATION,name);
+}
+
+}
@@ -0,0 +1,147 @@
+/*
+ * columnarResult.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_COLUMNARRESULT_H_
+#define LIGHTMYSQL_COLUMNARRESULT_H_
+
+#include <lightspeed/base/containers/autoArray.h>
+#include "result.h"
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+///Result converted to the columns
+/**
+ * Every column of the result is decoded once into a contiguous array
+ * of values of the type given by the column's type. Integer columns are
+ * stored as long long, floating point and decimal columns as double and
+ * other columns as text in a single buffer (arena) with an array of offsets.
+ * NULLs are marked in a bitmap.
+ *
+ * @code
+ * ColumnarResult cols(res);
+ * const ColumnarResult::Column &price = cols["price"];
+ * const double *p = price.getDoubles();
+ * double sum = 0;
+ * for (natural i = 0; i < cols.countRows(); i++) sum += p[i];
+ * @endcode
+ *
+ * Object doesn't depend on the Result, it can be kept after the result
+ * is destroyed.
+ */
+class ColumnarResult {
+public:
+
+	enum ColumnType {
+		///signed integer (and unsigned integer up to 32 bits) - getInts()
+		colInt,
+		///BIGINT UNSIGNED - getUInts()
+		colUInt,
+		///floating point and decimal number - getDoubles()
+		colDouble,
+		///text, binary and temporal types - getText()
+		colText
+	};
+
+	///Decoded column
+	class Column {
+	public:
+		Column():type(colText),nullCount(0) {}
+
+		///Retrieves name of the column
+		ConstStrA getName() const {return name;}
+		///Retrieves type of the column
+		ColumnType getType() const {return type;}
+		///Retrieves count of NULL values
+		natural getNullCount() const {return nullCount;}
+		///Tests, whether value is NULL
+		/**
+		 * @param row index of the row
+		 * @retval true value is NULL, array of values contains zero or empty string
+		 * @retval false value is not NULL
+		 */
+		bool isNull(natural row) const {return nullCount && ((nulls[row >> 3] >> (row & 7)) & 1) != 0;}
+		///Retrieves NULL bitmap
+		/** @return one bit per row, bit is set for NULL. Returns NULL, if there are no NULLs */
+		const unsigned char *getNullBitmap() const {return nullCount?nulls.data():0;}
+
+		///Retrieves values of the colInt column
+		const long long *getInts() const {return ints.data();}
+		///Retrieves values of the colUInt column
+		const unsigned long long *getUInts() const {return uints.data();}
+		///Retrieves values of the colDouble column
+		const double *getDoubles() const {return doubles.data();}
+		///Retrieves value of the colText column
+		/**
+		 * @param row index of the row
+		 * @return text of the value
+		 */
+		ConstStrA getText(natural row) const {
+			return ConstStrA(arena.data() + offsets[row], offsets[row+1] - offsets[row]);
+		}
+		///Retrieves buffer with all texts of the colText column
+		const char *getArena() const {return arena.data();}
+		///Retrieves offsets of the texts in the arena
+		/** Array has count of rows + 1 items, text of row i is between offsets[i] and offsets[i+1] */
+		const natural *getOffsets() const {return offsets.data();}
+
+	protected:
+		StringA name;
+		ColumnType type;
+		natural nullCount;
+		AutoArray<long long> ints;
+		AutoArray<unsigned long long> uints;
+		AutoArray<double> doubles;
+		AutoArray<char> arena;
+		AutoArray<natural> offsets;
+		AutoArray<unsigned char> nulls;
+
+		void setNull(natural row);
+
+		friend class ColumnarResult;
+	};
+
+	///Converts the current result
+	/**
+	 * @param res result. All rows of the current result are read from the beginning
+	 * @exception InvalidNumberFormatException numeric column contains invalid value
+	 */
+	ColumnarResult(Result &res);
+
+	///Retrieves count of rows
+	natural countRows() const {return rows;}
+	///Retrieves count of columns
+	natural countColumns() const {return columns.length();}
+	///Retrieves column
+	/**
+	 * @param index index of the column
+	 * @return column
+	 * @exception RangeException invalid index
+	 */
+	const Column &operator[](natural index) const;
+	///Retrieves column
+	/**
+	 * @param name name of the column
+	 * @return column
+	 * @exception FieldNotFoundException_t column doesn't exist
+	 */
+	const Column &operator[](ConstStrA name) const;
+
+	///Determines type of the column for the MySQL field
+	static ColumnType getColumnType(const MYSQL_FIELD *field);
+
+protected:
+	AutoArray<Column> columns;
+	natural rows;
+
+	void load(Result &res);
+};
+
+}
+
+#endif /* LIGHTMYSQL_COLUMNARRESULT_H_ */
@@ -0,0 +1,90 @@
+/*
+ * compiledQuery.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "compiledQuery.h"
+#include "query.h"
+#include <string.h>
+#include <ctype.h>
+#include <lightspeed/base/containers/autoArray.tcc>
+
+namespace LightMySQL {
+
+CompiledQuery::CompiledQuery(ConstStrA pattern):maxParam(0) {
+	compile(pattern);
+}
+
+void CompiledQuery::compile(ConstStrA pattern) {
+	this->pattern.clear();
+	this->pattern.append(pattern);
+	literals.clear();
+	segments.clear();
+	maxParam = 0;
+
+	const char *p = pattern.data();
+	const char *e = p + pattern.length();
+	std::size_t segStart = 0;
+	while (p != e) {
+		const char *m = (const char *)memchr(p,'%',e - p);
+		if (m == 0) {
+			literals.append(ConstStrA(p, e - p));
+			break;
+		}
+		literals.append(ConstStrA(p, m - p));
+		p = m + 1;
+		if (p == e || *p == '%') {
+			//"%%" - escaped percent sign, it is part of the literal
+			literals.add('%');
+			if (p != e) ++p;
+		} else {
+			std::size_t idx = 0;
+			while (p != e && isdigit(*p)) {
+				idx = idx * 10 + (*p - '0');
+				++p;
+			}
+			segments.add(Segment(segStart, literals.length() - segStart, idx));
+			segStart = literals.length();
+			if (idx > maxParam) maxParam = idx;
+		}
+	}
+	if (segStart < literals.length() || segments.empty())
+		segments.add(Segment(segStart, literals.length() - segStart, naturalNull));
+}
+
+void CompiledQuery::build(AutoArray<char> &out, ConstStrA params,
+		const std::size_t *paramEnds, std::size_t paramCount) const {
+
+	//first pass - validate references and calculate final length
+	std::size_t total = literals.length();
+	for (std::size_t i = 0; i < segments.length(); i++) {
+		const Segment &s = segments[i];
+		if (s.param == naturalNull) continue;
+		if (s.param < 1 || s.param > paramCount)
+			throw UnassignedQueryParameterException_t(THISLOCATION,pattern,s.param);
+		std::size_t b = s.param == 1?0:paramEnds[s.param-2];
+		total += paramEnds[s.param-1] - b;
+	}
+
+	//second pass - copy blocks
+	std::size_t pos = out.length();
+	out.resize(pos + total);
+	char *wr = out.data() + pos;
+	const char *lit = literals.data();
+	const char *par = params.data();
+	for (std::size_t i = 0; i < segments.length(); i++) {
+		const Segment &s = segments[i];
+		memcpy(wr, lit + s.offset, s.length);
+		wr += s.length;
+		if (s.param != naturalNull) {
+			std::size_t b = s.param == 1?0:paramEnds[s.param-2];
+			std::size_t l = paramEnds[s.param-1] - b;
+			memcpy(wr, par + b, l);
+			wr += l;
+		}
+	}
+}
+
+}
@@ -0,0 +1,119 @@
+/*
+ * compiledQuery.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_COMPILEDQUERY_H_
+#define LIGHTMYSQL_COMPILEDQUERY_H_
+
+#include <lightspeed/base/containers/autoArray.h>
+#include <lightspeed/base/containers/constStr.h>
+#include <lightspeed/base/containers/string.h>
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+///Query pattern parsed into literal segments and parameter slots
+/**
+ * Object parses the query pattern (see Query) only once. Then it can
+ * be used to build final queries repeatedly without scanning
+ * the pattern again. Each build() computes size of the final query, resizes
+ * the target buffer once and copies literals and parameters as whole blocks.
+ *
+ * Object is immutable after construction. It can be declared as static or
+ * global object and shared between threads. Pass it to
+ * Query::operator()(const CompiledQuery &) to use it.
+ *
+ * @code
+ * static const CompiledQuery selUser("SELECT * FROM users WHERE id=%1");
+ *
+ * Result res = query(selUser).arg(id).exec();
+ * @endcode
+ */
+class CompiledQuery {
+public:
+
+	///Constructs empty pattern
+	CompiledQuery():maxParam(0) {}
+	///Parses the pattern
+	/**
+	 * @param pattern query pattern
+	 */
+	CompiledQuery(ConstStrA pattern);
+
+	///Replaces current pattern with new one
+	/** Function reuses already allocated memory.
+	 * @param pattern new pattern
+	 */
+	void compile(ConstStrA pattern);
+
+	///Builds the query
+	/**
+	 * @param out target buffer. Final query is appended to the current content
+	 * @param params buffer containing all parameters
+	 * @param paramEnds array of indices into params where each parameter ends
+	 * @param paramCount count of items in paramEnds
+	 *
+	 * @exception UnassignedQueryParameterException_t pattern refers
+	 *   parameter that has not been assigned
+	 */
+	void build(AutoArray<char> &out, ConstStrA params,
+			const std::size_t *paramEnds, std::size_t paramCount) const;
+
+	///Retrieves original pattern
+	ConstStrA getPattern() const {return pattern;}
+
+	///Retrieves highest index of parameter referenced by the pattern
+	std::size_t getParamCount() const {return maxParam;}
+
+	///Retrieves count of segments
+	/** Each segment consists from a literal followed by optional
+	 * parameter reference
+	 */
+	std::size_t getSegmentCount() const {return segments.length();}
+
+	///Retrieves literal of the segment
+	ConstStrA getLiteral(std::size_t seg) const {
+		const Segment &s = segments[seg];
+		return ConstStrA(literals.data()+s.offset,s.length);
+	}
+
+	///Retrieves one-based index of the parameter that follows the literal
+	/**
+	 * @param seg index of segment
+	 * @return index of parameter, or naturalNull if literal is not followed
+	 * by a parameter. Value 0 means invalid reference
+	 */
+	std::size_t getParamIndex(std::size_t seg) const {return segments[seg].param;}
+
+protected:
+
+	struct Segment {
+		///offset of literal in the literals buffer
+		std::size_t offset;
+		///length of literal
+		std::size_t length;
+		///one-based index of parameter, naturalNull when there is no parameter
+		std::size_t param;
+
+		Segment(std::size_t offset, std::size_t length, std::size_t param)
+			:offset(offset),length(length),param(param) {}
+	};
+
+	///original pattern
+	AutoArray<char> pattern;
+	///all literals stored in one buffer ('%%' already unescaped)
+	AutoArray<char> literals;
+	///segments
+	AutoArray<Segment> segments;
+	///highest referenced parameter
+	std::size_t maxParam;
+
+};
+
+}
+
+#endif /* LIGHTMYSQL_COMPILEDQUERY_H_ */
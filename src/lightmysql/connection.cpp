@@ -14,7 +14,9 @@
 
 #include "connection.h"
 #include "result.h"
+#include "streamResult.h"
 #include "mysql/errmsg.h"
+#include <string.h>
 #include <lightspeed/base/containers/autoArray.tcc>
 #include <lightspeed/base/memory/smallAlloc.h>
 
@@ -24,14 +26,16 @@ namespace LightMySQL {
 static ThreadHook thrhook;
 
 Connection::Connection()
-	:connected(false),logObject(0),transactionObjects(0)
+	:connected(false),streaming(false),nonBlocking(false),logObject(0),transactionObjects(0),sessionCounter(0)
+	,fastEscape(false),escapeCharset(escSingleByte),maxPreparedStmts(0)
 {
 	thrhook.install();
 	mysql_init(&conn);
 }
 
 Connection::Connection(const ConnectParams &params, unsigned long flags /*= 0*/)
-	:connected(false),logObject(0),transactionObjects(0)
+	:connected(false),streaming(false),nonBlocking(false),logObject(0),transactionObjects(0),sessionCounter(0)
+	,fastEscape(false),escapeCharset(escSingleByte),maxPreparedStmts(0)
 {
 	mysql_init(&conn);
 	connect(params,flags);
@@ -54,6 +58,9 @@ void Connection::close()
 		reconnectParams.lifetime = ConnectParams::defaultLifetime;
 		mysql_close(&conn);
 		connected = false;
+		streaming = false;
+		nonBlocking = false;
+		onSessionClosed();
 		if (logObject)
 			logObject->serverDisconnect();
 	}
@@ -64,22 +71,75 @@ void Connection::closeTemporary()
 	if (connected) {
 		mysql_close(&conn);
 		connected = false;
+		streaming = false;
+		nonBlocking = false;
+		onSessionClosed();
 		if (logObject)
 			logObject->serverDisconnect();
 	}
 }
 
+std::size_t Connection::escapeTo(char *target, ConstStrA str) {
+	if (fastEscape && (conn.server_status & SERVER_STATUS_NO_BACKSLASH_ESCAPES) == 0)
+		return mysqlEscape(target,str.data(),str.length(),escapeCharset);
+	else
+		return mysql_real_escape_string(&conn,target,str.data(),str.length());
+}
+
 StringA Connection::escapeString(ConstStrA str) {
 	AutoArray<char, SmallAlloc<256> > buff;
 	buff.resize(str.length()*2+1);
-	unsigned int cnt = mysql_real_escape_string(
-					&conn,buff.data(),str.data(),str.length());
+	std::size_t cnt = escapeTo(buff.data(),str);
 	return StringA(ConstStrA(buff.data(),cnt));
 }
 
+void Connection::escapeString(ConstStrA str, AutoArray<char> &buffer) {
+	std::size_t pos = buffer.length();
+	buffer.resize(pos+str.length()*2+1);
+	std::size_t cnt = escapeTo(buffer.data()+pos,str);
+	buffer.resize(pos+cnt);
+}
+
+void Connection::initEscaping() {
+	MY_CHARSET_INFO cs;
+	mysql_get_character_set_info(&conn,&cs);
+	fastEscape = true;
+	if (cs.mbmaxlen <= 1) {
+		escapeCharset = escSingleByte;
+#ifdef LIBMARIADB
+	//Connector/C copies bytes of invalid utf8 sequences without escaping
+	} else if (strncmp(cs.csname,"utf8",4) == 0) {
+		escapeCharset = escSingleByte;
+#else
+	} else if (strcmp(cs.csname,"utf8mb4") == 0) {
+		escapeCharset = escUtf8mb4;
+	} else if (strcmp(cs.csname,"utf8") == 0 || strcmp(cs.csname,"utf8mb3") == 0) {
+		escapeCharset = escUtf8mb3;
+#endif
+	} else {
+		fastEscape = false;
+	}
+}
+
+natural Connection::getMaxPreparedStatements() {
+	if (maxPreparedStmts) return maxPreparedStmts;
+	maxPreparedStmts = naturalNull;
+	try {
+		Result res = executeQuery("SELECT @@max_prepared_stmt_count");
+		if (res.hasItems()) {
+			natural v = res.getNext()[0].as<natural>();
+			if (v) maxPreparedStmts = v;
+		}
+	} catch (ServerError_t &) {
+		//variable is not available - the limit is unknown
+	}
+	return maxPreparedStmts;
+}
+
 Result Connection::executeQuery(ConstStrA query) {
 	if (connected == false)
 		throw ServerError_t(THISLOCATION,2006,"mysql is disconnected");
+	checkIdle(THISLOCATION);
 	if (logObject) logObject->onQueryExec(query);
 	if (mysql_real_query(&conn,query.data(),query.length()) != 0) {
 		if (logObject) logObject->onQueryError(mysql_error(&conn));
@@ -88,11 +148,63 @@ Result Connection::executeQuery(ConstStrA query) {
 	return Result(conn, logObject);
 }
 
+UpdateResult IConnection::executeUpdate(ConstStrA query) {
+	Result res = executeQuery(query);
+	return UpdateResult(res.getAffectedRows(),res.getInsertId(),res.getWarningCount());
+}
+
+UpdateResult Connection::executeUpdate(ConstStrA query) {
+	if (connected == false)
+		throw ServerError_t(THISLOCATION,2006,"mysql is disconnected");
+	checkIdle(THISLOCATION);
+	if (logObject) logObject->onQueryExec(query);
+	if (mysql_real_query(&conn,query.data(),query.length()) != 0) {
+		if (logObject) logObject->onQueryError(mysql_error(&conn));
+		handleError(THISLOCATION);
+	}
+	if (mysql_field_count(&conn) == 0 && !mysql_more_results(&conn)) {
+		UpdateResult r(mysql_affected_rows(&conn),mysql_insert_id(&conn),mysql_warning_count(&conn));
+		if (logObject) {
+			const char *info = mysql_info(&conn);
+			if (info) logObject->onQueryInfo(info);
+			logObject->onQueryResult(0,0,r.affected,r.insertId,r.warnings);
+		}
+		return r;
+	}
+	//statement returned rows or multiple results
+	Result res(conn, logObject);
+	return UpdateResult(res.getAffectedRows(),res.getInsertId(),res.getWarningCount());
+}
+
+StreamResult Connection::executeStream(ConstStrA query) {
+	if (connected == false)
+		throw ServerError_t(THISLOCATION,2006,"mysql is disconnected");
+	checkIdle(THISLOCATION);
+	if (logObject) logObject->onQueryExec(query);
+	if (mysql_real_query(&conn,query.data(),query.length()) != 0) {
+		if (logObject) logObject->onQueryError(mysql_error(&conn));
+		handleError(THISLOCATION);
+	}
+	return StreamResult(*this);
+}
+
+void NoDirectConnectionException_t::message(LightSpeed::ExceptionMsg &msg) const {
+	msg("Operation needs direct connection to the server");
+}
+
+void Connection::checkIdle(const ProgramLocation &loc) const {
+	if (streaming)
+		throw ServerError_t(loc,CR_COMMANDS_OUT_OF_SYNC,"Commands out of sync; streamed result is still open");
+}
+
 void Connection::handleError(const ProgramLocation &l) {
 	int errnr = mysql_errno(&conn);
 	if (errnr == CR_SERVER_GONE_ERROR || errnr == CR_SERVER_LOST) {
 		mysql_close(&conn);
 		connected = false;
+		streaming = false;
+		nonBlocking = false;
+		onSessionClosed();
 	}
 	if (errnr != 0) {
 		throw ServerError_t(l,errnr,mysql_error(&conn));
@@ -149,30 +261,33 @@ void Connection::reconnect() {
 	if (res == 0) handleError(THISLOCATION);
 
 	connected = true;
+	nonBlocking = false;
+	sessionCounter++;
 	if (logObject)
 		logObject->serverConnect(params.host, params.port, params.dbname);
 	executeQuery("SET NAMES utf8");
+	initEscaping();
+	//limit is read when it is needed
+	maxPreparedStmts = 0;
 }
 
-void Connection::openTransactionWithLevel(Level isolationLevel) {
-	const char* levelstr = 0;
+const char *Connection::getIsolationLevelName(Level isolationLevel) {
 	switch (isolationLevel) {
 	case readCommited:
-		levelstr = "READ COMMITTED";
-		break;
+		return "READ COMMITTED";
 	case readUncommited:
-		levelstr = "READ UNCOMMITTED";
-		break;
+		return "READ UNCOMMITTED";
 	case repeatable:
-		levelstr = "REPEATABLE READ";
-		break;
+		return "REPEATABLE READ";
 	case serializable:
-		levelstr = "SERIALIZABLE";
-		break;
+		return "SERIALIZABLE";
 	default:
-		levelstr = 0;
-		break;
+		return 0;
 	}
+}
+
+void Connection::openTransactionWithLevel(Level isolationLevel) {
+	const char* levelstr = getIsolationLevelName(isolationLevel);
 	if (levelstr)
 		executeQuery(StringA(ConstStrA("SET TRANSACTION ISOLATION LEVEL ")
 								+ ConstStrA(levelstr)));
@@ -24,6 +24,7 @@
 #include "exception.h"
 #include "logging.h"
 #include "iconnection.h"
+#include "escape.h"
 
 namespace LightMySQL {
 
@@ -88,6 +89,7 @@ struct ConnectParams {
 };
 
 class Result;
+class StreamResult;
 
 ///MySQL connection. First object that must be created to communicate with the database
 class Connection: public LightSpeed::SharedResource, public IConnection {
@@ -135,6 +137,13 @@ public:
 	 * @see Query
 	 */
 	StringA escapeString(ConstStrA str);
+	///Escapes string directly into the buffer
+	/**
+	 * @param str string to escape
+	 * @param buffer buffer which receives escaped string. String is appended
+	 * to the current content of the buffer.
+	 */
+	void escapeString(ConstStrA str, AutoArray<char> &buffer);
 
 	///Executes query
 	/**
@@ -144,6 +153,32 @@ public:
 	 * @return result of query
 	 */
 	Result executeQuery(ConstStrA query);
+	///Executes query and streams its result
+	/**
+	 * Rows are not stored in the client memory, they are read from
+	 * the server as they are fetched by the StreamResult. Connection
+	 * remains busy until the stream is read to the end or cancelled
+	 *
+	 * @param query query to execute
+	 * @return streamed result
+	 * @exception ServerError_t connection is busy by another stream (CR_COMMANDS_OUT_OF_SYNC)
+	 */
+	StreamResult executeStream(ConstStrA query);
+	///Executes statement which doesn't return rows
+	/**
+	 * Function doesn't create the Result, when the statement produces
+	 * single result without rows. Otherwise it falls back to executeQuery()
+	 *
+	 * @param query statement to execute
+	 * @return count of affected rows, insert id and count of warnings
+	 */
+	UpdateResult executeUpdate(ConstStrA query);
+	///Checks, whether streamed result is open
+	/**
+	 * @retval true streamed result is open, no other query can be executed
+	 * @retval false connection is idle
+	 */
+	bool isStreaming() const {return streaming;}
 	///Handles any MySQL error throwing appropriate exception
 	/**
 	 * @param e location in the program, where error has been retrieved.
@@ -159,6 +194,8 @@ public:
 	 */
 	bool isConnected() const {return connected;}
 
+	virtual Connection *getDirectConnection() {return this;}
+
 	///Sets logging interface
 	/**
 	 * @param logObject pointer to object implementing IDebugLog interface.
@@ -184,8 +221,29 @@ public:
 	///Rollbacks transaction
 	void rollbackTransaction();
 
+	///Retrieves name of the isolation level as used in SET TRANSACTION
+	/**
+	 * @param isolationLevel isolation level
+	 * @return name of the level, or NULL for defaultLevel
+	 */
+	static const char *getIsolationLevelName(Level isolationLevel);
+
 	natural getConnectionId();
 
+	///Retrieves counter of the sessions
+	/** Counter is increased on every successful connect. Objects bound
+	 * to the session (for example prepared statements) can use the
+	 * counter to detect, that the session has been reopened
+	 */
+	natural getSessionCounter() const {return sessionCounter;}
+
+	///Retrieves limit of prepared statements of the server
+	/** Value of max_prepared_stmt_count is read on the first call in the session,
+	 * the connection must not be busy by other query.
+	 * @return limit, or naturalNull, if the limit is not known
+	 */
+	natural getMaxPreparedStatements();
+
 	void killConnection(natural connectionId);
 
 
@@ -196,16 +254,40 @@ public:
 protected:
 
 	friend class Result;
+	friend class PreparedQuery;
+	friend class StatementCache;
+	friend class BulkLoader;
+	friend class QueryBatch;
+	friend class AsyncReactor;
+	friend class StreamResult;
 
 	mutable MYSQL conn;
 	bool connected;
+	///true, if a streamed result is open
+	bool streaming;
+	///true, if non-blocking API has been enabled for the current session
+	bool nonBlocking;
 
 	IDebugLog *logObject;
 	ConnectParams reconnectParams;
 	unsigned long reconnectFlags;
 	unsigned long transactionObjects;
+	natural sessionCounter;
+	///true, if strings can be escaped by mysqlEscape() instead of the client library
+	bool fastEscape;
+	///charset handling for mysqlEscape()
+	EscapeCharset escapeCharset;
+	///value of max_prepared_stmt_count, naturalNull if unknown, 0 if not read yet
+	natural maxPreparedStmts;
 
 	void closeTemporary();
+	///Throws exception, if a streamed result is open
+	void checkIdle(const ProgramLocation &loc) const;
+	///Called when the session has been closed
+	/** Overwrite to release objects bound to the session */
+	virtual void onSessionClosed() {}
+	void initEscaping();
+	std::size_t escapeTo(char *target, ConstStrA str);
 	void openTransactionWithLevel(Level isolationLevel);
 };
 
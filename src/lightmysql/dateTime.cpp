@@ -0,0 +1,126 @@
+/*
+ * dateTime.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "dateTime.h"
+
+namespace LightMySQL {
+
+///reads two digits at the position
+static inline bool digits2(const char *p, unsigned int &out) {
+	unsigned int a = (unsigned char)p[0] - '0';
+	unsigned int b = (unsigned char)p[1] - '0';
+	if (a > 9 || b > 9) return false;
+	out = a * 10 + b;
+	return true;
+}
+
+///reads four digits at the position
+static inline bool digits4(const char *p, unsigned int &out) {
+	unsigned int hi, lo;
+	if (!digits2(p,hi) || !digits2(p + 2,lo)) return false;
+	out = hi * 100 + lo;
+	return true;
+}
+
+///parses hh:mm:ss[.ffffff] or hhh:mm:ss[.ffffff]
+static inline bool parseTime(const char *p, const char *e, DBDateTime &dt, bool longHours) {
+	natural l = e - p;
+	unsigned int h;
+	if (longHours && l >= 9 && p[3] == ':') {
+		unsigned int h1;
+		unsigned int h0 = (unsigned char)p[0] - '0';
+		if (h0 > 9 || !digits2(p + 1,h1)) return false;
+		h = h0 * 100 + h1;
+		p++;
+		l--;
+	} else {
+		if (l < 8 || !digits2(p,h)) return false;
+		//datetime has hours in range 0-23, time can be longer
+		if (!longHours && h > 23) return false;
+	}
+	if (p[2] != ':' || p[5] != ':') return false;
+	if (!digits2(p + 3,dt.minute) || !digits2(p + 6,dt.second)) return false;
+	if (dt.minute > 59 || dt.second > 59) return false;
+	dt.hour = h;
+	p += 8;
+	if (p != e) {
+		if (*p != '.') return false;
+		++p;
+		natural fl = e - p;
+		if (fl < 1 || fl > 6) return false;
+		unsigned int f = 0;
+		for (natural i = 0; i < 6; i++) {
+			unsigned int d = 0;
+			if (i < fl) {
+				d = (unsigned char)p[i] - '0';
+				if (d > 9) return false;
+			}
+			f = f * 10 + d;
+		}
+		dt.microsecond = f;
+		dt.fracDigits = (unsigned int)fl;
+	}
+	dt.hasTime = true;
+	return true;
+}
+
+bool DBDateTime::parse(ConstStrA text) {
+	const char *p = text.data();
+	const char *e = p + text.length();
+	natural l = text.length();
+	*this = DBDateTime();
+	if (l >= 10 && p[4] == '-' && p[7] == '-') {
+		if (!digits4(p,year) || !digits2(p + 5,month) || !digits2(p + 8,day)) return false;
+		if (month > 12 || day > 31) return false;
+		hasDate = true;
+		if (l == 10) return true;
+		if (p[10] != ' ' && p[10] != 'T') return false;
+		return parseTime(p + 11,e,*this,false);
+	} else {
+		return parseTime(p,e,*this,true);
+	}
+}
+
+TimeStamp DBDateTime::toTimeStamp() const {
+	return TimeStamp::fromYMDhms(year,month,day,hour,minute,second);
+}
+
+///writes number with fixed count of digits
+static inline char *putDigits(char *p, unsigned int val, int digits) {
+	for (int i = digits - 1; i >= 0; i--) {
+		p[i] = (char)('0' + val % 10);
+		val /= 10;
+	}
+	return p + digits;
+}
+
+natural DBDateTime::formatISO(char *buff) const {
+	char *p = buff;
+	if (hasDate) {
+		p = putDigits(p,year,4);
+		*p++ = '-';
+		p = putDigits(p,month,2);
+		*p++ = '-';
+		p = putDigits(p,day,2);
+		if (hasTime) *p++ = 'T';
+	}
+	if (hasTime) {
+		p = putDigits(p,hour,hour > 99?3:2);
+		*p++ = ':';
+		p = putDigits(p,minute,2);
+		*p++ = ':';
+		p = putDigits(p,second,2);
+		if (fracDigits) {
+			*p++ = '.';
+			p = putDigits(p,microsecond,6);
+		}
+		if (hasDate) *p++ = 'Z';
+	}
+	return p - buff;
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * dateTime.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_DATETIME_H_
+#define LIGHTMYSQL_DATETIME_H_
+
+#include <lightspeed/base/containers/constStr.h>
+#include <lightspeed/base/timestamp.h>
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+///Date and time in the text form produced by the server
+/**
+ * Parser accepts fixed layouts of DATE, DATETIME, TIMESTAMP and TIME columns
+ *
+ *  - YYYY-MM-DD
+ *  - YYYY-MM-DD hh:mm:ss
+ *  - YYYY-MM-DD hh:mm:ss.ffffff (1 to 6 digits of the fraction)
+ *  - hh:mm:ss, hhh:mm:ss, optionally with the fraction
+ *
+ * Digits are extracted from the known positions, parser doesn't allocate
+ * memory. Zero dates (0000-00-00) are accepted.
+ */
+class DBDateTime {
+public:
+	unsigned int year;
+	unsigned int month;
+	unsigned int day;
+	unsigned int hour;
+	unsigned int minute;
+	unsigned int second;
+	unsigned int microsecond;
+	///count of digits of the fraction (0 - no fraction)
+	unsigned int fracDigits;
+	///text contains date
+	bool hasDate;
+	///text contains time
+	bool hasTime;
+
+	DBDateTime()
+		:year(0),month(0),day(0),hour(0),minute(0),second(0),microsecond(0)
+		,fracDigits(0),hasDate(false),hasTime(false) {}
+
+	///Parses the text
+	/**
+	 * @param text text to parse
+	 * @retval true parsed
+	 * @retval false text has invalid format
+	 */
+	bool parse(ConstStrA text);
+
+	///Converts to the TimeStamp
+	/** Fraction of the second is not converted (same as TimeStamp::fromYMDhms) */
+	TimeStamp toTimeStamp() const;
+
+	///Maximum length of the ISO form
+	static const natural isoMaxLength = 32;
+
+	///Formats ISO 8601 form
+	/**
+	 * Date and time is formatted as YYYY-MM-DDThh:mm:ss[.ffffff]Z, date only
+	 * as YYYY-MM-DD and time only as hh:mm:ss[.ffffff]
+	 *
+	 * @param buff buffer, at least isoMaxLength characters
+	 * @return length of the text
+	 */
+	natural formatISO(char *buff) const;
+};
+
+}
+
+#endif /* LIGHTMYSQL_DATETIME_H_ */
@@ -0,0 +1,234 @@
+/*
+ * escape.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "escape.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace LightMySQL {
+
+///escape character for each byte, zero if byte is not escaped
+static const char escapeTable[256] = {
+	'0',0,0,0,0,0,0,0,0,0,'n',0,0,'r',0,0,
+	0,0,0,0,0,0,0,0,0,0,'Z',0,0,0,0,0,
+	0,0,'"',0,0,0,0,'\'',0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,'\\',0,0,0,
+};
+
+static inline bool isCont(unsigned char c) {
+	return (unsigned char)(c ^ 0x80) < 0x40;
+}
+
+///length of valid multi-byte sequence at s, 0 if there is no valid multi-byte sequence
+/** follows my_ismbchar() of libmysqlclient for utf8 and utf8mb4 */
+static inline std::size_t validMBLength(const unsigned char *s, const unsigned char *e, bool mb4) {
+	unsigned char c = s[0];
+	if (c < 0xc2) return 0;
+	if (c < 0xe0) {
+		if (e - s < 2 || !isCont(s[1])) return 0;
+		return 2;
+	}
+	if (c < 0xf0) {
+		if (e - s < 3 || !isCont(s[1]) || !isCont(s[2])
+				|| (c < 0xe1 && s[1] < 0xa0)) return 0;
+		return 3;
+	}
+	if (mb4 && c < 0xf8) {
+		if (e - s < 4 || !isCont(s[1]) || !isCont(s[2]) || !isCont(s[3])
+				|| (c < 0xf1 && s[1] < 0x90) || (c > 0xf3 && s[1] > 0x8f)) return 0;
+		return 4;
+	}
+	return 0;
+}
+
+///true, if byte looks like a lead byte of a multi-byte character
+/** follows my_mbcharlen() of libmysqlclient for utf8 and utf8mb4 */
+static inline bool isLeadByte(unsigned char c, bool mb4) {
+	return c >= 0xc2 && (c < 0xf0 || (mb4 && c < 0xf8));
+}
+
+///escapes one character at s (which can be multi-byte)
+static inline void escapeChar(const unsigned char *&s, const unsigned char *e,
+		char *&d, EscapeCharset charset) {
+	unsigned char c = *s;
+	if (c >= 0x80 && charset != escSingleByte) {
+		bool mb4 = charset == escUtf8mb4;
+		std::size_t l = validMBLength(s,e,mb4);
+		if (l) {
+			memcpy(d,s,l);
+			d += l;
+			s += l;
+			return;
+		}
+		//invalid sequence - libmysqlclient escapes its lead byte
+		if (isLeadByte(c,mb4)) *d++ = '\\';
+		*d++ = (char)c;
+		++s;
+		return;
+	}
+	char x = escapeTable[c];
+	if (x) {
+		*d++ = '\\';
+		*d++ = x;
+	} else {
+		*d++ = (char)c;
+	}
+	++s;
+}
+
+std::size_t mysqlEscapeScalar(char *target, const char *src, std::size_t length, EscapeCharset charset) {
+	const unsigned char *s = reinterpret_cast<const unsigned char *>(src);
+	const unsigned char *e = s + length;
+	char *d = target;
+	while (s != e) escapeChar(s,e,d,charset);
+	*d = 0;
+	return d - target;
+}
+
+#if defined(__AVX2__)
+
+static const std::size_t blockSize = 32;
+
+///returns bit mask of bytes in the block which need special handling
+static inline unsigned int specialMask(const unsigned char *s, bool high) {
+	__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+	__m256i m = _mm256_or_si256(
+		_mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(x,_mm256_setzero_si256()),
+					_mm256_cmpeq_epi8(x,_mm256_set1_epi8('\n'))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(x,_mm256_set1_epi8('\r')),
+					_mm256_cmpeq_epi8(x,_mm256_set1_epi8('\\')))),
+		_mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(x,_mm256_set1_epi8('\'')),
+					_mm256_cmpeq_epi8(x,_mm256_set1_epi8('"'))),
+			_mm256_cmpeq_epi8(x,_mm256_set1_epi8('\032'))));
+	unsigned int r = (unsigned int)_mm256_movemask_epi8(m);
+	if (high) r |= (unsigned int)_mm256_movemask_epi8(x);
+	return r;
+}
+
+///returns bit mask of bytes in the block which must be escaped in JSON
+static inline unsigned int jsonSpecialMask(const unsigned char *s) {
+	__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+	__m256i ctl = _mm256_set1_epi8(0x1F);
+	__m256i m = _mm256_or_si256(
+		_mm256_cmpeq_epi8(_mm256_max_epu8(x,ctl),ctl),
+		_mm256_or_si256(_mm256_cmpeq_epi8(x,_mm256_set1_epi8('"')),
+				_mm256_cmpeq_epi8(x,_mm256_set1_epi8('\\'))));
+	return (unsigned int)_mm256_movemask_epi8(m);
+}
+
+static inline void copyBlock(char *d, const unsigned char *s) {
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(d),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s)));
+}
+
+#elif defined(__SSE2__)
+
+static const std::size_t blockSize = 16;
+
+static inline unsigned int specialMask(const unsigned char *s, bool high) {
+	__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+	__m128i m = _mm_or_si128(
+		_mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(x,_mm_setzero_si128()),
+					_mm_cmpeq_epi8(x,_mm_set1_epi8('\n'))),
+			_mm_or_si128(_mm_cmpeq_epi8(x,_mm_set1_epi8('\r')),
+					_mm_cmpeq_epi8(x,_mm_set1_epi8('\\')))),
+		_mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(x,_mm_set1_epi8('\'')),
+					_mm_cmpeq_epi8(x,_mm_set1_epi8('"'))),
+			_mm_cmpeq_epi8(x,_mm_set1_epi8('\032'))));
+	unsigned int r = (unsigned int)_mm_movemask_epi8(m);
+	if (high) r |= (unsigned int)_mm_movemask_epi8(x);
+	return r;
+}
+
+static inline unsigned int jsonSpecialMask(const unsigned char *s) {
+	__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+	__m128i ctl = _mm_set1_epi8(0x1F);
+	__m128i m = _mm_or_si128(
+		_mm_cmpeq_epi8(_mm_max_epu8(x,ctl),ctl),
+		_mm_or_si128(_mm_cmpeq_epi8(x,_mm_set1_epi8('"')),
+				_mm_cmpeq_epi8(x,_mm_set1_epi8('\\'))));
+	return (unsigned int)_mm_movemask_epi8(m);
+}
+
+static inline void copyBlock(char *d, const unsigned char *s) {
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(d),
+			_mm_loadu_si128(reinterpret_cast<const __m128i *>(s)));
+}
+
+#endif
+
+std::size_t mysqlEscape(char *target, const char *src, std::size_t length, EscapeCharset charset) {
+#if defined(__AVX2__) || defined(__SSE2__)
+	if (length < blockSize)
+		return mysqlEscapeScalar(target,src,length,charset);
+	const unsigned char *s = reinterpret_cast<const unsigned char *>(src);
+	const unsigned char *e = s + length;
+	char *d = target;
+	bool high = charset != escSingleByte;
+	//target has space for 2*length+1 bytes, so whole block can be
+	//always stored even if only part of it is valid
+	while ((std::size_t)(e - s) >= blockSize) {
+		const unsigned char *blk = s;
+		unsigned int mask = specialMask(blk,high);
+		if (mask == 0) {
+			copyBlock(d,s);
+			s += blockSize;
+			d += blockSize;
+			continue;
+		}
+		do {
+			const unsigned char *sp = blk + __builtin_ctz(mask);
+			mask &= mask - 1;
+			//byte has been already processed as part of multi-byte character
+			if (sp < s) continue;
+			if ((std::size_t)(e - s) >= blockSize) copyBlock(d,s);
+			else memcpy(d,s,sp - s);
+			d += sp - s;
+			s = sp;
+			escapeChar(s,e,d,charset);
+		} while (mask);
+		const unsigned char *blkEnd = blk + blockSize;
+		if (s < blkEnd) {
+			if ((std::size_t)(e - s) >= blockSize) copyBlock(d,s);
+			else memcpy(d,s,blkEnd - s);
+			d += blkEnd - s;
+			s = blkEnd;
+		}
+	}
+	//the tail is shorter than the block
+	return (d - target) + mysqlEscapeScalar(d,reinterpret_cast<const char *>(s),e - s,charset);
+#else
+	return mysqlEscapeScalar(target,src,length,charset);
+#endif
+}
+
+std::size_t jsonFindSpecial(const char *src, std::size_t length) {
+	const unsigned char *s = reinterpret_cast<const unsigned char *>(src);
+	const unsigned char *e = s + length;
+#if defined(__AVX2__) || defined(__SSE2__)
+	while ((std::size_t)(e - s) >= blockSize) {
+		unsigned int mask = jsonSpecialMask(s);
+		if (mask) return (s - reinterpret_cast<const unsigned char *>(src)) + __builtin_ctz(mask);
+		s += blockSize;
+	}
+#endif
+	while (s != e && *s >= 0x20 && *s != '"' && *s != '\\') ++s;
+	return s - reinterpret_cast<const unsigned char *>(src);
+}
+
+}
@@ -0,0 +1,59 @@
+/*
+ * escape.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_ESCAPE_H_
+#define LIGHTMYSQL_ESCAPE_H_
+
+#include <cstddef>
+
+namespace LightMySQL {
+
+///Character set handling of the escaper
+enum EscapeCharset {
+	///single-byte charset (latin1, ascii, ...) - only ASCII special characters are escaped
+	escSingleByte,
+	///utf8 (utf8mb3)
+	escUtf8mb3,
+	///utf8mb4
+	escUtf8mb4
+};
+
+///Escapes string for MySQL
+/**
+ * Function produces the same output as mysql_real_escape_string() for
+ * given charset, when NO_BACKSLASH_ESCAPES mode is not active. Input is
+ * scanned by 16 (SSE2) or 32 (AVX2) bytes at once, blocks without special
+ * characters are copied as whole.
+ *
+ * @param target target buffer. It must have space for at least length*2+1 characters
+ * @param src source string
+ * @param length length of the source string
+ * @param charset charset handling. For utf8 charsets, function also
+ *   handles invalid multi-byte sequences the same way as libmysqlclient
+ * @return length of escaped string. Terminating zero is also written, but
+ *   it is not counted.
+ */
+std::size_t mysqlEscape(char *target, const char *src, std::size_t length, EscapeCharset charset);
+
+///Escapes string for MySQL using scalar code only
+/** Reference implementation, it produces the same result as mysqlEscape() */
+std::size_t mysqlEscapeScalar(char *target, const char *src, std::size_t length, EscapeCharset charset);
+
+///Finds first character, which must be escaped in the JSON string
+/**
+ * Looks for the quote, the backslash and the control characters. Input is
+ * scanned by the same SSE2 or AVX2 code as in the mysqlEscape().
+ *
+ * @param src source string
+ * @param length length of the source string
+ * @return offset of the first such character, or length, if there is none
+ */
+std::size_t jsonFindSpecial(const char *src, std::size_t length);
+
+}
+
+#endif /* LIGHTMYSQL_ESCAPE_H_ */
@@ -107,6 +107,22 @@ using LightSpeed::ProgramLocation;
 		void message(LightSpeed::ExceptionMsg &msg) const;
 	};
 
+	///Exception - Operation needs the Connection
+	/**
+	 * Streamed results and asynchronous queries cannot be executed
+	 * through the IConnection which doesn't have the direct connection
+	 * (see IConnection::getDirectConnection())
+	 */
+	class NoDirectConnectionException_t: public Exception_t {
+	public:
+		LIGHTSPEED_EXCEPTIONFINAL;
+
+		NoDirectConnectionException_t(const ProgramLocation &loc)
+			:Exception_t(loc) {}
+	protected:
+		void message(LightSpeed::ExceptionMsg &msg) const;
+	};
+
 	class EnumException: public Exception_t {
 	public:
 		LIGHTSPEED_EXCEPTIONFINAL;
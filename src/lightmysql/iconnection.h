@@ -9,6 +9,7 @@
 #define LightMySQL_ICONNECTION_H_
 #include <lightspeed/base/containers/constStr.h>
 #include <lightspeed/base/containers/string.h>
+#include <lightspeed/base/containers/autoArray.h>
 #include <lightspeed/base/interface.h>
 
 
@@ -18,6 +19,22 @@ namespace LightMySQL {
 using namespace LightSpeed;
 
 	class Result;
+	class Connection;
+
+	///Result of the statement which doesn't return rows
+	/** Small value object, it doesn't allocate memory */
+	struct UpdateResult {
+		///count of affected rows
+		unsigned long long affected;
+		///value generated for AUTO_INCREMENT column
+		unsigned long long insertId;
+		///count of warnings
+		natural warnings;
+
+		UpdateResult():affected(0),insertId(0),warnings(0) {}
+		UpdateResult(unsigned long long affected, unsigned long long insertId, natural warnings)
+			:affected(affected),insertId(insertId),warnings(warnings) {}
+	};
 
 	class IConnection: public LightSpeed::IInterface {
 	public:
@@ -32,7 +49,29 @@ using namespace LightSpeed;
 
 
 		virtual Result executeQuery(ConstStrA query) = 0;
+		///Executes statement which doesn't return rows
+		/**
+		 * @param query statement to execute
+		 * @return count of affected rows, insert id and count of warnings. If
+		 * the statement returns rows, they are discarded
+		 *
+		 * @note default implementation calls executeQuery(). Override it
+		 * to avoid construction of the Result
+		 */
+		virtual UpdateResult executeUpdate(ConstStrA query);
 		virtual StringA escapeString(ConstStrA str) = 0;
+		///Escapes string and appends the result to the buffer
+		/**
+		 * @param str string to escape
+		 * @param buffer buffer which receives escaped string. String is
+		 * appended to the current content
+		 *
+		 * @note default implementation calls escapeString(ConstStrA). Override
+		 * it to avoid temporary string
+		 */
+		virtual void escapeString(ConstStrA str, AutoArray<char> &buffer) {
+			buffer.append(escapeString(str));
+		}
 		virtual void startTransaction(Level isolationLevel = defaultLevel) = 0;
 		virtual void commitTransaction() = 0;
 		virtual void rollbackTransaction() = 0;
@@ -49,6 +88,14 @@ using namespace LightSpeed;
 		 */
 		virtual bool isLogEnabled() const = 0;
 		virtual bool isConnected() const = 0;
+		///Retrieves the connection, which executes the queries directly
+		/**
+		 * Streamed results and asynchronous queries need the Connection
+		 *
+		 * @return pointer to the connection, or NULL, if queries are not
+		 * executed directly (for example, the shared transaction)
+		 */
+		virtual Connection *getDirectConnection() {return 0;}
 
 
 
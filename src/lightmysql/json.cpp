@@ -6,61 +6,45 @@
  */
 
 #include "json.h"
+#include "dateTime.h"
+#include "resultJsonWriter.h"
+#include "jsonText.h"
+#include "escape.h"
+#include <ctype.h>
 #include <lightspeed/base/text/textParser.tcc>
 #include <lightspeed/base/containers/convertString.tcc>
 #include <lightspeed/utils/base64.tcc>
+#include <lightspeed/base/sync/synchronize.h>
 namespace LightMySQL {
 
 
 const char *message_InvalidDateTimeFormat = "Invalid date/time: %1";
+const char *message_UnsupportedSetSeparator = "Separator of the set (code %1) cannot be used in the server query";
 
 static bool isoDate;
 
 TimeStamp parseDateTime(ConstStrA text) {
-	using namespace LightSpeed;
-	TextParser<char, StaticAlloc<256> > parser;
-	if (parser("%u1-%u2-%u3 %u4:%u5:%u6",text)) {
-		natural yr = parser[1],
-				mh = parser[2],
-				dy = parser[3],
-				hh = parser[4],
-				mn = parser[5],
-				sc = parser[6];
-			return TimeStamp::fromYMDhms(yr,mh,dy,hh,mn,sc);
-	} else if (parser("%u1-%u2-%u3",text)) {
-		natural yr = parser[1],
-				mh = parser[2],
-				dy = parser[3];
-		return TimeStamp::fromYMDhms(yr,mh,dy,0,0,0);
-	} else if (parser("%u1:%u2:%u3",text)) {
-		natural hh = parser[1],
-				mn = parser[2],
-				sc = parser[3];
-		return TimeStamp::fromYMDhms(0,0,0,hh,mn,sc);
-	} else {
-		throw InvalidDateTimeFormat(THISLOCATION, text);
-	}
-
-
+	DBDateTime dt;
+	if (!dt.parse(text)) throw InvalidDateTimeFormat(THISLOCATION, text);
+	return dt.toTimeStamp();
 }
 
 LightSpeed::JSON::PNode parseDateTime(LightSpeed::JSON::IFactory &factory, ConstStrA text, bool strDate) {
 	using namespace LightSpeed;
 
-	if (strDate) {
-		if (!isoDate)
-			return factory.newValue(text);
-		else
-			return factory.newValue(StringA(text.head(10)+ConstStrA("T")+text.tail(8)+ConstStrA("Z")));
-	}
+	if (strDate && !isoDate)
+		return factory.newValue(text);
 
-	try {
-		TimeStamp tms = parseDateTime(text);
-		return factory.newValue(tms.getFloat());
-	} catch (const InvalidDateTimeFormat &e) {
-		return factory.newValue(e.getMessage());
+	DBDateTime dt;
+	if (!dt.parse(text)) {
+		if (strDate) return factory.newValue(text);
+		return factory.newValue(InvalidDateTimeFormat(THISLOCATION, text).getMessage());
 	}
-
+	if (strDate) {
+		char buff[DBDateTime::isoMaxLength];
+		return factory.newValue(ConstStrA(buff,dt.formatISO(buff)));
+	}
+	return factory.newValue(dt.toTimeStamp().getFloat());
 }
 
 
@@ -194,11 +178,13 @@ DBResultToJSON::DBResultToJSON(const LightSpeed::JSON::PFactory &factory, const
 
 void DBResultToJSON::setFormat(LightSpeed::natural index, FieldFormat fld) {
 	rowDesc(index).format = fld;
+	plan = nil;
 }
 
 void DBResultToJSON::setFormat(LightSpeed::ConstStrA name, FieldFormat fld) {
 	for (LightSpeed::natural i = 0; i < rowDesc.length();i++)
 		if (rowDesc[i].name == name) rowDesc(i).format = fld;
+	plan = nil;
 }
 
 void DBResultToJSON::setGroup(LightSpeed::ConstStrA name) {
@@ -206,10 +192,12 @@ void DBResultToJSON::setGroup(LightSpeed::ConstStrA name) {
 		if (rowDesc[i].name.head(name.length()) == name) {
 			rowDesc(i).groupSep = name.length() - 1;
 		}
+	plan = nil;
 
 }
 void DBResultToJSON::setGroupSeparator(char sep) {
 	groupSep = sep;
+	plan = nil;
 }
 
 
@@ -224,76 +212,311 @@ LightSpeed::JSON::PNode DBResultToJSON::getHeader() {
 }
 
 
+LightSpeed::JSON::PNode DBResultToJSON::getValue(const LightMySQL::Row& row, LightSpeed::natural i) {
+	using namespace LightSpeed;
+	const RowItem &r = rowDesc[i];
+	if (row[i].isNull()) return factory->newNullNode();
+	switch (r.format) {
+		case integer: return factory->newValue(row[i].as<LightSpeed::integer>());
+		case datetime: return parseDateTime(*factory,row[i].as<ConstStrA>(),strDate);
+		case floatnum: return factory->newValue(row[i].as<double>());
+		case string: return factory->newValue(row[i].as<ConstStrA>());
+		case set: return createArrayFromSet(*factory,row[i].as<ConstStrA>());
+		case setWithCustomSep1: return createArrayFromSet(*factory,row[i].as<ConstStrA>(),customSep1);
+		case setWithCustomSep2: return createArrayFromSet(*factory,row[i].as<ConstStrA>(),customSep2);
+		case binary: return factory->newValue(convertString(Base64Encoder(),row[i].as<ConstBin>()));
+		case jsonstr: {
+			ConstStrA txt = row[i].as<ConstStrA>();
+			if (txt.empty()) return factory->newNullNode();
+			//invalid text is detected without the exception
+			if (!JsonText::validate(txt)) return factory->newValue(txt);
+			try {
+				return factory->fromString(txt);
+			} catch (...) {
+				return factory->newValue(txt);
+			}
+		}
+		case boolean: {
+			ConstStrA s = row[i].as<ConstStrA>();
+			return factory->newValue(s != "false" && s != "FALSE" && s != "False" && s != "0");
+		}
+		default: return factory->newValue(row[i].as<ConstStrA>());
+	}
+}
+
+LightSpeed::JSON::PNode DBResultToJSON::getGroup(const LightMySQL::Row& row, const GroupPlan &plan, LightSpeed::natural slot) {
+	using namespace LightSpeed;
+	JSON::PNode obj = slot?factory->newObject():factory->newClass();
+	for (natural c = plan.slots[slot].firstChild; c != naturalNull; c = plan.slots[c].next) {
+		const GroupPlan::Slot &s = plan.slots[c];
+		if (s.field == naturalNull) obj->add(s.name,getGroup(row,plan,c));
+		else obj->add(s.name,getValue(row,s.field));
+	}
+	return obj;
+}
+
 LightSpeed::JSON::PNode DBResultToJSON::getRow(const LightMySQL::Row& row) {
 	using namespace LightSpeed;
-	JSON::PNode obj = buildArray?factory->newArray():factory->newClass();
-	natural c = row.size();
-	for (natural i = 0; i < c; i++) {
+	const GroupPlan &p = getPlan();
+	if (buildArray) {
+		JSON::PNode arr = factory->newArray();
+		for (natural i = 0; i < p.order.length(); i++)
+			arr->add(getValue(row,p.order[i]));
+		return arr;
+	} else {
+		return getGroup(row,p,0);
+	}
+}
+
+DBResultToJSON::GroupPlan::Slot::Slot(LightSpeed::ConstStrA name, LightSpeed::natural field)
+	:name(name),field(field),firstChild(LightSpeed::naturalNull),next(LightSpeed::naturalNull)
+{
+	LightSpeed::AutoArray<char> k;
+	ResultJsonWriter::writeString(k,name);
+	k.add(':');
+	key = ConstStrA(k.data(),k.length());
+}
+
+LightSpeed::natural DBResultToJSON::GroupPlan::addSlot(LightSpeed::natural parent, LightSpeed::ConstStrA name, LightSpeed::natural field) {
+	using namespace LightSpeed;
+	natural last = naturalNull;
+	for (natural c = slots[parent].firstChild; c != naturalNull; c = slots[c].next) {
+		//groups of the same name are merged
+		if (field == naturalNull && slots[c].field == naturalNull && ConstStrA(slots[c].name) == name)
+			return c;
+		last = c;
+	}
+	natural idx = slots.length();
+	slots.add(Slot(name,field));
+	if (last == naturalNull) slots(parent).firstChild = idx;
+	else slots(last).next = idx;
+	return idx;
+}
+
+void DBResultToJSON::GroupPlan::compile(const RowDesc &rowDesc, char groupSep, bool buildArray) {
+	using namespace LightSpeed;
+	slots.add(Slot(ConstStrA(),naturalNull));
+	for (natural i = 0; i < rowDesc.length(); i++) {
 		const RowItem &r = rowDesc[i];
 		if (r.format == skip) continue;
-		JSON::PNode nd;
-
-		if (row[i].isNull()) {
-			nd = factory->newNullNode();
-		} else {
-			switch (r.format) {
-				case integer: nd = factory->newValue(row[i].as<LightSpeed::integer>());break;
-				case datetime: nd = parseDateTime(*factory,row[i].as<ConstStrA>(),strDate);break;
-				case floatnum: nd = factory->newValue(row[i].as<double>());break;
-				case string: nd = factory->newValue(row[i].as<ConstStrA>());break;
-				case set: nd = createArrayFromSet(*factory,row[i].as<ConstStrA>());break;
-				case setWithCustomSep1: nd = createArrayFromSet(*factory,row[i].as<ConstStrA>(),customSep1);break;
-				case setWithCustomSep2: nd = createArrayFromSet(*factory,row[i].as<ConstStrA>(),customSep2);break;
-				case binary: nd = factory->newValue(convertString(Base64Encoder(),row[i].as<ConstBin>()));
-				case jsonstr: {
-					if (row[i].as<ConstStrA>().empty()) nd = factory->newNullNode();
-					else {
-						try {
-							nd = factory->fromString(row[i].as<ConstStrA>());
-						} catch (...) {
-							nd = factory->newValue(row[i].as<ConstStrA>());
-						}
-					}
-					break;
-				}
-				case boolean: {
-					ConstStrA s = row[i].as<ConstStrA>();
-					nd = factory->newValue(s != "false" && s != "FALSE" && s != "False" && s != "0");
-				}
-				break;
-				default: continue;
-			}
-		}
+		order.add(i);
+		if (buildArray) continue;
 		if (r.groupSep != naturalNull) {
-			ConstStrA grname = r.name.head(r.groupSep);
-			ConstStrA itemName = r.name.offset(r.groupSep+1);
-			JSON::PNode e = obj->getVariable(grname);
-			if (e == nil) {
-				e = factory->newObject();
-				obj->add(grname,e);
-			}
-			e->add(itemName,nd);
+			natural g = addSlot(0,r.name.head(r.groupSep),naturalNull);
+			addSlot(g,r.name.offset(r.groupSep + 1),i);
 		} else if (groupSep) {
-			ConstStrA name = r.name;
-			JSON::Value cont = obj;
-			ConstStrA::SplitIterator splt = name.split(groupSep);
+			natural parent = 0;
+			ConstStrA::SplitIterator splt = r.name.split(groupSep);
 			ConstStrA curLevel = splt.getNext();
 			while (splt.hasItems()) {
-				JSON::Value c2 = cont[curLevel];
-				if (c2 == null) {
-					c2 = factory->object();
-					cont.set(curLevel,c2);
-				}
-				cont = c2;
+				parent = addSlot(parent,curLevel,naturalNull);
 				curLevel = splt.getNext();
 			}
-			cont.set(curLevel,nd);
+			addSlot(parent,curLevel,i);
 		} else {
-			obj->add(r.name,nd);
+			addSlot(0,r.name,i);
 		}
+	}
+}
+
+DBResultToJSON::PlanCache DBResultToJSON::planCache;
+LightSpeed::FastLock DBResultToJSON::planCacheLock;
 
+const DBResultToJSON::GroupPlan &DBResultToJSON::getPlan() {
+	using namespace LightSpeed;
+	if (plan != nil) return *plan;
+
+	AutoArray<char> sig;
+	sig.add(groupSep);
+	sig.add(buildArray?'a':'o');
+	for (natural i = 0; i < rowDesc.length(); i++) {
+		const RowItem &r = rowDesc[i];
+		sig.append(r.name);
+		sig.add(0);
+		sig.add((char)r.format);
+		sig.add(r.groupSep == naturalNull?(char)0:(char)(r.groupSep + 1));
 	}
-	return obj;
+	StringA key(ConstStrA(sig.data(),sig.length()));
+
+	Synchronized<FastLock> _(planCacheLock);
+	const PGroupPlan *found = planCache.find(key);
+	if (found) {
+		plan = *found;
+	} else {
+		PGroupPlan p = new GroupPlan;
+		p->compile(rowDesc,groupSep,buildArray);
+		//plans are shared between threads
+		plan = p.getMT();
+		if (planCache.length() >= planCacheLimit) planCache.clear();
+		planCache.insert(key,plan);
+	}
+	return *plan;
+}
+
+///appends SQL string literal
+static void appendSqlString(LightSpeed::AutoArray<char> &out, LightSpeed::ConstStrA text) {
+	LightSpeed::AutoArray<char> buff;
+	buff.resize(text.length() * 2 + 1);
+	std::size_t len = mysqlEscape(buff.data(),text.data(),text.length(),escUtf8mb4);
+	out.add('\'');
+	out.append(LightSpeed::ConstStrA(buff.data(),len));
+	out.add('\'');
+}
+
+///alias of the wrapped select
+static const char *serverQueryAlias = "_json_src";
+
+///appends reference to the column of the wrapped select
+static void appendSqlColumn(LightSpeed::AutoArray<char> &out, LightSpeed::ConstStrA name) {
+	out.append(LightSpeed::ConstStrA(serverQueryAlias));
+	out.append(LightSpeed::ConstStrA(".`"));
+	for (LightSpeed::natural i = 0; i < name.length(); i++) {
+		if (name[i] == '`') out.add('`');
+		out.add(name[i]);
+	}
+	out.add('`');
+}
+
+static bool isServerIntegerType(enum_field_types t) {
+	switch (t) {
+		case MYSQL_TYPE_TINY:
+		case MYSQL_TYPE_SHORT:
+		case MYSQL_TYPE_INT24:
+		case MYSQL_TYPE_LONG:
+		case MYSQL_TYPE_LONGLONG: return true;
+		default: return false;
+	}
+}
+
+static bool isServerNumberType(enum_field_types t) {
+	switch (t) {
+		case MYSQL_TYPE_FLOAT:
+		case MYSQL_TYPE_DOUBLE:
+		case MYSQL_TYPE_DECIMAL:
+		case MYSQL_TYPE_NEWDECIMAL: return true;
+		default: return isServerIntegerType(t);
+	}
+}
+
+///separator can be replaced in the output of JSON_QUOTE
+/** Letters and digits are part of escape sequences (\n, \u001f), control
+ * characters are escaped, so they cannot be found */
+static bool isServerSetSeparator(char sep) {
+	return sep >= ' ' && sep < 127 && sep != '"' && sep != '\\'
+			&& !isalnum((unsigned char)sep);
+}
+
+void DBResultToJSON::getServerValue(LightSpeed::AutoArray<char> &out, LightSpeed::natural index) {
+	using namespace LightSpeed;
+	const RowItem &r = rowDesc[index];
+	const MYSQL_FIELD *fld = result.getFieldInfo(index);
+	AutoArray<char> col;
+	appendSqlColumn(col,ConstStrA(fld->name,fld->name_length));
+	ConstStrA c(col.data(),col.length());
+	switch (r.format) {
+		case datetime: {
+			bool hasDate = fld->type != MYSQL_TYPE_TIME;
+			bool hasTime = fld->type != MYSQL_TYPE_DATE && fld->type != MYSQL_TYPE_NEWDATE;
+			if (!isoDate || !hasDate || !hasTime) {
+				//DATE and TIME are already in the ISO format
+				out.append(ConstStrA("CAST("));out.append(c);out.append(ConstStrA(" AS CHAR)"));
+			} else {
+				//the same format as DBDateTime::formatISO
+				out.append(ConstStrA("DATE_FORMAT("));out.append(c);
+				out.append(ConstStrA(fld->decimals > 0 && fld->decimals <= 6
+						?",'%Y-%m-%dT%H:%i:%s.%fZ')":",'%Y-%m-%dT%H:%i:%sZ')"));
+			}
+			break;
+		}
+		case set:
+		case setWithCustomSep1:
+		case setWithCustomSep2: {
+			char sep = r.format == set?',':r.format == setWithCustomSep1?customSep1:customSep2;
+			//separator is replaced in the quoted text, so it must not be part of an escape sequence
+			if (!isServerSetSeparator(sep))
+				throw UnsupportedSetSeparator(THISLOCATION,(natural)(unsigned char)sep);
+			//items are joined by "," and empty items ,"" are removed. Text is converted
+			//to JSON by JSON_EXTRACT (MariaDB doesn't support CAST AS JSON)
+			out.append(ConstStrA("JSON_EXTRACT(CONCAT('[', SUBSTRING(REPLACE(CONCAT(',', REPLACE(JSON_QUOTE("));
+			out.append(c);out.append(ConstStrA("), "));appendSqlString(out,ConstStrA(&sep,1));
+			out.append(ConstStrA(", '\",\"')), ',\"\"', ''), 2), ']'), '$')"));
+			break;
+		}
+		case binary:
+			//TO_BASE64 breaks lines
+			out.append(ConstStrA("REPLACE(TO_BASE64("));out.append(c);out.append(ConstStrA("), '\\n', '')"));
+			break;
+		case jsonstr:
+			//invalid json is returned as string, empty as null
+			out.append(ConstStrA("JSON_EXTRACT(IF(JSON_VALID(NULLIF("));out.append(c);
+			out.append(ConstStrA(", '')), "));out.append(c);
+			out.append(ConstStrA(", JSON_QUOTE(NULLIF("));out.append(c);out.append(ConstStrA(", ''))), '$')"));
+			break;
+		case boolean:
+			out.append(ConstStrA("JSON_EXTRACT(IF("));out.append(c);
+			out.append(ConstStrA(" IS NULL, NULL, IF(BINARY "));out.append(c);
+			out.append(ConstStrA(" IN ('false','FALSE','False','0'), 'false', 'true')), '$')"));
+			break;
+		case integer:
+			if (isServerIntegerType(fld->type)) out.append(c);
+			else {out.append(ConstStrA("CAST("));out.append(c);out.append(ConstStrA(" AS SIGNED)"));}
+			break;
+		case floatnum:
+			//CAST AS DOUBLE is not available in MySQL 5.7
+			if (isServerNumberType(fld->type)) out.append(c);
+			else {out.append(ConstStrA("("));out.append(c);out.append(ConstStrA(" + 0E0)"));}
+			break;
+		default:
+			//DECIMAL, YEAR and BIT would be numbers
+			out.append(ConstStrA("CAST("));out.append(c);out.append(ConstStrA(" AS CHAR)"));
+			break;
+	}
+}
+
+void DBResultToJSON::getServerGroup(LightSpeed::AutoArray<char> &out, const GroupPlan &plan, LightSpeed::natural slot) {
+	using namespace LightSpeed;
+	out.append(ConstStrA("JSON_OBJECT("));
+	bool first = true;
+	for (natural c = plan.slots[slot].firstChild; c != naturalNull; c = plan.slots[c].next) {
+		const GroupPlan::Slot &s = plan.slots[c];
+		if (!first) out.append(ConstStrA(", "));
+		first = false;
+		appendSqlString(out,s.name);
+		out.append(ConstStrA(", "));
+		if (s.field == naturalNull) getServerGroup(out,plan,c);
+		else getServerValue(out,s.field);
+	}
+	out.add(')');
+}
+
+LightSpeed::StringA DBResultToJSON::getServerQuery(LightSpeed::ConstStrA selectQuery, bool aggregate) {
+	using namespace LightSpeed;
+	const GroupPlan &p = getPlan();
+	AutoArray<char> expr;
+	if (buildArray) {
+		expr.append(ConstStrA("JSON_ARRAY("));
+		for (natural i = 0; i < p.order.length(); i++) {
+			if (i) expr.append(ConstStrA(", "));
+			getServerValue(expr,p.order[i]);
+		}
+		expr.add(')');
+	} else {
+		getServerGroup(expr,p,0);
+	}
+	AutoArray<char> q;
+	q.append(ConstStrA("SELECT "));
+	if (aggregate) {
+		q.append(ConstStrA("COALESCE(JSON_ARRAYAGG("));
+		q.append(ConstStrA(expr.data(),expr.length()));
+		q.append(ConstStrA("), JSON_ARRAY())"));
+	} else {
+		q.append(ConstStrA(expr.data(),expr.length()));
+	}
+	q.append(ConstStrA(" AS json FROM ("));
+	q.append(selectQuery);
+	q.append(ConstStrA(") AS "));
+	q.append(ConstStrA(serverQueryAlias));
+	return StringA(ConstStrA(q.data(),q.length()));
 }
 
 ConstStrA dbDateTimeFormat("%Y-%m-%d %H:%M:%S");
@@ -10,6 +10,9 @@
 
 #include <lightspeed/base/containers/autoArray.h>
 #include <lightspeed/base/memory/smallAlloc.h>
+#include <lightspeed/base/memory/refCntPtr.h>
+#include <lightspeed/base/containers/map.h>
+#include <lightspeed/mt/fastlock.h>
 #include <lightspeed/utils/json.h>
 
 #include "result.h"
@@ -76,6 +79,37 @@ public:
 	void setCustomSet2(char x) {customSep2 = x;}
 	LightSpeed::JSON::PNode getHeader();
 
+	///Builds query, which generates JSON on the server
+	/**
+	 * Query wraps the select into JSON_OBJECT (or JSON_ARRAY for buildArray)
+	 * with the same names, groups and formats as the getRow(). Server returns
+	 * JSON text, which can be passed to the output without parsing. Function needs
+	 * MySQL 5.7.22 or newer (MariaDB 10.5).
+	 *
+	 * Sets are split on the server, so the separator of the set must be
+	 * a space or a punctuation character other than the quote and the backslash,
+	 * otherwise UnsupportedSetSeparator is thrown. Text of the number is
+	 * converted by the server (CAST AS SIGNED, + 0E0), invalid numbers become
+	 * zero with a warning, while getRow() throws an exception.
+	 *
+	 * @code
+	 * StringA sql = conv.getServerQuery(q.build(),true);
+	 * Result res = q("%1").raw(sql).exec();
+	 * @endcode
+	 *
+	 * @param selectQuery the select, which has been used to get the result
+	 * of this object (the result can be empty, only fields are needed). Names of
+	 * fields must be unique
+	 * @param aggregate true to return single row with the array of all rows
+	 * (JSON_ARRAYAGG, order of rows is not guaranteed), false to return one
+	 * JSON per row
+	 * @return query text
+	 *
+	 * @note Dates are always generated as strings (ISO format when enabled),
+	 * numeric timestamp has no equivalent on the server.
+	 */
+	LightSpeed::StringA getServerQuery(LightSpeed::ConstStrA selectQuery, bool aggregate);
+
 	static void enableISODate(bool isoDate);
 	static bool isISODateEnabled();
 
@@ -89,6 +123,47 @@ protected:
 	};
 
 	typedef LightSpeed::AutoArray<RowItem, LightSpeed::SmallAlloc<16> > RowDesc;
+
+	///Compiled layout of the output row
+	/**
+	 * Plan is compiled from the configuration once per result schema. Rows are
+	 * converted by walking the plan, so names are not split for every row. Plans
+	 * are immutable and cached, results of the same query share the plan.
+	 */
+	class GroupPlan: public LightSpeed::RefCntObj {
+	public:
+		///Item of the output, either the field or the group
+		struct Slot {
+			///name of the item
+			LightSpeed::StringA name;
+			///name as JSON string including quotes and colon
+			LightSpeed::StringA key;
+			///index of the field, naturalNull for the group
+			LightSpeed::natural field;
+			///first item of the group
+			LightSpeed::natural firstChild;
+			///next item on the same level
+			LightSpeed::natural next;
+
+			Slot(LightSpeed::ConstStrA name, LightSpeed::natural field);
+		};
+		///slots, first slot is the root object
+		LightSpeed::AutoArray<Slot> slots;
+		///fields in the order of the output (skipped fields are not included)
+		LightSpeed::AutoArray<LightSpeed::natural> order;
+
+		void compile(const RowDesc &rowDesc, char groupSep, bool buildArray);
+	protected:
+		LightSpeed::natural addSlot(LightSpeed::natural parent, LightSpeed::ConstStrA name, LightSpeed::natural field);
+	};
+
+	typedef LightSpeed::RefCntPtr<GroupPlan> PGroupPlan;
+	///cache of compiled plans, key is the signature of the configuration
+	typedef LightSpeed::Map<LightSpeed::StringA, PGroupPlan> PlanCache;
+	static PlanCache planCache;
+	static LightSpeed::FastLock planCacheLock;
+	///count of plans, when the cache is cleared
+	static const LightSpeed::natural planCacheLimit = 256;
 	LightSpeed::JSON::PFactory factory;
 	const LightMySQL::Result &result;
 	bool strDate;
@@ -97,6 +172,19 @@ protected:
 	char customSep1;
 	char customSep2;
 	char groupSep;
+	///compiled plan, nil when configuration has been changed
+	PGroupPlan plan;
+
+	///retrieves compiled plan, uses the cache
+	const GroupPlan &getPlan();
+	///converts single value
+	LightSpeed::JSON::PNode getValue(const LightMySQL::Row &row, LightSpeed::natural index);
+	///converts group of the plan
+	LightSpeed::JSON::PNode getGroup(const LightMySQL::Row &row, const GroupPlan &plan, LightSpeed::natural slot);
+	///appends SQL expression of the value
+	void getServerValue(LightSpeed::AutoArray<char> &out, LightSpeed::natural index);
+	///appends SQL expression of the group
+	void getServerGroup(LightSpeed::AutoArray<char> &out, const GroupPlan &plan, LightSpeed::natural slot);
 
 private:
 	void init(LightSpeed::natural count, const LightMySQL::Result& result, bool hideAl);
@@ -106,6 +194,10 @@ extern const char *message_InvalidDateTimeFormat;
 
 typedef LightSpeed::GenException1<message_InvalidDateTimeFormat, ConstStrA> InvalidDateTimeFormat;
 
+extern const char *message_UnsupportedSetSeparator;
+
+typedef LightSpeed::GenException1<message_UnsupportedSetSeparator, LightSpeed::natural> UnsupportedSetSeparator;
+
 LightSpeed::JSON::PNode createArrayFromSet(LightSpeed::JSON::IFactory &factory, ConstStrA text, char sep = ',');
 
 LightSpeed::TimeStamp parseDateTime(ConstStrA text);
@@ -0,0 +1,314 @@
+/*
+ * jsonText.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "jsonText.h"
+#include "escape.h"
+#include "numberParse.h"
+#include <lightspeed/base/containers/autoArray.tcc>
+#include <lightspeed/base/memory/smallAlloc.h>
+
+namespace LightMySQL {
+
+///maximum nesting of arrays and objects
+static const natural maxDepth = 512;
+
+static inline bool isWs(char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline const char *skipWs(const char *p, const char *e) {
+	while (p < e && isWs(*p)) p++;
+	return p;
+}
+
+static inline bool isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+static inline int hexValue(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+///skips string, p points to the opening quote, returns NULL if invalid
+static const char *skipString(const char *p, const char *e) {
+	p++;
+	while (p < e) {
+		p += jsonFindSpecial(p,e - p);
+		if (p == e) break;
+		unsigned char c = (unsigned char)*p;
+		if (c == '"') return p + 1;
+		if (c < 0x20) return 0;
+		if (c == '\\') {
+			if (++p >= e) return 0;
+			switch (*p) {
+			case '"': case '\\': case '/':
+			case 'b': case 'f': case 'n': case 'r': case 't': break;
+			case 'u':
+				if (e - p < 5) return 0;
+				for (int i = 1; i <= 4; i++) if (hexValue(p[i]) < 0) return 0;
+				p += 4;
+				break;
+			default: return 0;
+			}
+		}
+		p++;
+	}
+	return 0;
+}
+
+static const char *skipDigits(const char *p, const char *e) {
+	const char *s = p;
+	while (p < e && isDigit(*p)) p++;
+	return p == s?0:p;
+}
+
+static const char *skipNumber(const char *p, const char *e) {
+	if (*p == '-') p++;
+	if (p >= e) return 0;
+	if (*p == '0') p++;
+	else if ((p = skipDigits(p,e)) == 0) return 0;
+	if (p < e && *p == '.') {
+		if ((p = skipDigits(p + 1,e)) == 0) return 0;
+	}
+	if (p < e && (*p == 'e' || *p == 'E')) {
+		p++;
+		if (p < e && (*p == '+' || *p == '-')) p++;
+		if ((p = skipDigits(p,e)) == 0) return 0;
+	}
+	return p;
+}
+
+static const char *skipLiteral(const char *p, const char *e, ConstStrA lit) {
+	if ((natural)(e - p) < lit.length() || ConstStrA(p,lit.length()) != lit) return 0;
+	return p + lit.length();
+}
+
+///skips value, p points to the first character, returns NULL if invalid
+static const char *skipValue(const char *p, const char *e, natural depth) {
+	if (p >= e) return 0;
+	switch (*p) {
+	case '"': return skipString(p,e);
+	case 't': return skipLiteral(p,e,"true");
+	case 'f': return skipLiteral(p,e,"false");
+	case 'n': return skipLiteral(p,e,"null");
+	case '{':
+	case '[': {
+		if (depth >= maxDepth) return 0;
+		bool obj = *p == '{';
+		char close = obj?'}':']';
+		p = skipWs(p + 1,e);
+		if (p < e && *p == close) return p + 1;
+		while (true) {
+			if (obj) {
+				if (p >= e || *p != '"') return 0;
+				if ((p = skipString(p,e)) == 0) return 0;
+				p = skipWs(p,e);
+				if (p >= e || *p != ':') return 0;
+				p = skipWs(p + 1,e);
+			}
+			if ((p = skipValue(p,e,depth + 1)) == 0) return 0;
+			p = skipWs(p,e);
+			if (p >= e) return 0;
+			if (*p == close) return p + 1;
+			if (*p != ',') return 0;
+			p = skipWs(p + 1,e);
+		}
+	}
+	default:
+		if (*p == '-' || isDigit(*p)) return skipNumber(p,e);
+		return 0;
+	}
+}
+
+///appends code point as UTF-8
+static void appendUtf8(AutoArray<char, SmallAlloc<256> > &out, unsigned int cp) {
+	if (cp < 0x80) {
+		out.add((char)cp);
+	} else if (cp < 0x800) {
+		out.add((char)(0xC0 | (cp >> 6)));
+		out.add((char)(0x80 | (cp & 0x3F)));
+	} else if (cp < 0x10000) {
+		out.add((char)(0xE0 | (cp >> 12)));
+		out.add((char)(0x80 | ((cp >> 6) & 0x3F)));
+		out.add((char)(0x80 | (cp & 0x3F)));
+	} else {
+		out.add((char)(0xF0 | (cp >> 18)));
+		out.add((char)(0x80 | ((cp >> 12) & 0x3F)));
+		out.add((char)(0x80 | ((cp >> 6) & 0x3F)));
+		out.add((char)(0x80 | (cp & 0x3F)));
+	}
+}
+
+static unsigned int readHex4(const char *p) {
+	return (hexValue(p[0]) << 12) | (hexValue(p[1]) << 8) | (hexValue(p[2]) << 4) | hexValue(p[3]);
+}
+
+///unescapes content of the string, text contains the string without quotes
+static StringA unescape(ConstStrA text) {
+	AutoArray<char, SmallAlloc<256> > out;
+	const char *p = text.data();
+	const char *e = p + text.length();
+	while (p < e) {
+		if (*p != '\\' || e - p < 2) {
+			out.add(*p++);
+			continue;
+		}
+		p++;
+		char c = *p++;
+		switch (c) {
+		case 'b': out.add('\b');break;
+		case 'f': out.add('\f');break;
+		case 'n': out.add('\n');break;
+		case 'r': out.add('\r');break;
+		case 't': out.add('\t');break;
+		case 'u': {
+			if (e - p < 4) return StringA(ConstStrA(out.data(),out.length()));
+			unsigned int cp = readHex4(p);
+			p += 4;
+			//surrogate pair
+			if (cp >= 0xD800 && cp < 0xDC00 && e - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+				unsigned int lo = readHex4(p + 2);
+				if (lo >= 0xDC00 && lo < 0xE000) {
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+					p += 6;
+				}
+			}
+			appendUtf8(out,cp);
+			break;
+		}
+		default: out.add(c);break;
+		}
+	}
+	return StringA(ConstStrA(out.data(),out.length()));
+}
+
+JsonText::JsonText(ConstStrA text) {
+	const char *p = text.data();
+	const char *e = p + text.length();
+	p = skipWs(p,e);
+	while (e > p && isWs(e[-1])) e--;
+	this->text = ConstStrA(p,e - p);
+}
+
+bool JsonText::validate(ConstStrA text) {
+	const char *p = text.data();
+	const char *e = p + text.length();
+	p = skipWs(p,e);
+	p = skipValue(p,e,0);
+	return p != 0 && skipWs(p,e) == e;
+}
+
+JsonText::Type JsonText::getType() const {
+	if (text.empty()) return typeInvalid;
+	switch (text[0]) {
+	case '{': return typeObject;
+	case '[': return typeArray;
+	case '"': return typeString;
+	case 't':
+	case 'f': return typeBool;
+	case 'n': return typeNull;
+	default: return (text[0] == '-' || isDigit(text[0]))?typeNumber:typeInvalid;
+	}
+}
+
+JsonText JsonText::operator[](ConstStrA key) const {
+	if (getType() != typeObject) return JsonText();
+	const char *p = text.data();
+	const char *e = p + text.length();
+	p = skipWs(p + 1,e);
+	if (p < e && *p == '}') return JsonText();
+	while (p < e && *p == '"') {
+		const char *k = p;
+		if ((p = skipString(p,e)) == 0) break;
+		ConstStrA name(k + 1,p - k - 2);
+		p = skipWs(p,e);
+		if (p >= e || *p != ':') break;
+		const char *v = skipWs(p + 1,e);
+		if ((p = skipValue(v,e,0)) == 0) break;
+		//escaped names are compared unescaped
+		bool escaped = name.find('\\') != naturalNull;
+		if (escaped?ConstStrA(unescape(name)) == key:name == key)
+			return JsonText(ConstStrA(v,p - v));
+		p = skipWs(p,e);
+		if (p >= e || *p != ',') break;
+		p = skipWs(p + 1,e);
+	}
+	return JsonText();
+}
+
+JsonText JsonText::operator[](natural index) const {
+	if (getType() != typeArray) return JsonText();
+	const char *p = text.data();
+	const char *e = p + text.length();
+	p = skipWs(p + 1,e);
+	if (p < e && *p == ']') return JsonText();
+	for (natural i = 0; p < e; i++) {
+		const char *v = p;
+		if ((p = skipValue(v,e,0)) == 0) break;
+		if (i == index) return JsonText(ConstStrA(v,p - v));
+		p = skipWs(p,e);
+		if (p >= e || *p != ',') break;
+		p = skipWs(p + 1,e);
+	}
+	return JsonText();
+}
+
+natural JsonText::length() const {
+	Type t = getType();
+	if (t != typeArray && t != typeObject) return 0;
+	const char *p = text.data();
+	const char *e = p + text.length();
+	char close = t == typeObject?'}':']';
+	p = skipWs(p + 1,e);
+	if (p < e && *p == close) return 0;
+	natural cnt = 0;
+	while (p < e) {
+		if (t == typeObject) {
+			if (*p != '"' || (p = skipString(p,e)) == 0) break;
+			p = skipWs(p,e);
+			if (p >= e || *p != ':') break;
+			p = skipWs(p + 1,e);
+		}
+		if ((p = skipValue(p,e,0)) == 0) break;
+		cnt++;
+		p = skipWs(p,e);
+		if (p >= e || *p != ',') break;
+		p = skipWs(p + 1,e);
+	}
+	return cnt;
+}
+
+bool JsonText::getBool() const {
+	return text == ConstStrA("true");
+}
+
+double JsonText::getNumber() const {
+	if (getType() != typeNumber) return 0;
+	//text is not terminated by zero, the parser can fall back to the C library
+	AutoArray<char, SmallAlloc<64> > buff;
+	buff.append(text);
+	buff.add(0);
+	return parseFloatField<double>(ConstStrA(buff.data(),text.length()));
+}
+
+StringA JsonText::getString() const {
+	if (getType() != typeString || text.length() < 2) return StringA(text);
+	return unescape(text.offset(1).head(text.length() - 2));
+}
+
+JSON::PNode JsonText::toNode(JSON::IFactory &factory) const {
+	return factory.fromString(text);
+}
+
+JsonText FieldTypeConv<JsonText>::convert(const FieldContent &f) {
+	return JsonText(f.as<ConstStrA>());
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+ * jsonText.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_JSONTEXT_H_
+#define LIGHTMYSQL_JSONTEXT_H_
+
+#include <lightspeed/utils/json.h>
+#include "row.h"
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+///JSON document stored as text, parsed lazily
+/**
+ * Object refers the text, it doesn't copy it. Values are located
+ * by scanning the text when they are accessed, no nodes are allocated.
+ * Access to the missing value or to the invalid text returns
+ * the object of the type typeInvalid.
+ *
+ * @code
+ * JsonText doc = row["attributes"].as<JsonText>();
+ * double w = doc["size"]["width"].getNumber();
+ * @endcode
+ *
+ * @note Object is valid while the text is valid (usually until the next
+ * row is fetched)
+ */
+class JsonText {
+public:
+	enum Type {
+		///missing value or invalid text
+		typeInvalid,
+		typeNull,
+		typeBool,
+		typeNumber,
+		typeString,
+		typeArray,
+		typeObject
+	};
+
+	JsonText() {}
+	///Constructs object above the text
+	/** @param text JSON text. It is not validated, see valid() */
+	explicit JsonText(ConstStrA text);
+
+	///Validates JSON text
+	/**
+	 * @param text text to validate
+	 * @retval true text is single valid JSON value
+	 * @retval false text is not valid
+	 */
+	static bool validate(ConstStrA text);
+
+	///Validates the text of the object
+	bool valid() const {return validate(text);}
+
+	///Retrieves type of the value
+	/** Type is determined by the first character, value is not validated */
+	Type getType() const;
+	///Retrieves text of the value
+	ConstStrA getText() const {return text;}
+
+	///Retrieves member of the object
+	JsonText operator[](ConstStrA key) const;
+	///Retrieves member of the object
+	JsonText operator[](const char *key) const {return operator[](ConstStrA(key));}
+	///Retrieves item of the array
+	JsonText operator[](natural index) const;
+	///Retrieves count of items of the array or members of the object
+	natural length() const;
+
+	bool isNull() const {return getType() == typeNull;}
+	bool getBool() const;
+	double getNumber() const;
+	///Retrieves content of the string (unescaped), other values as text
+	StringA getString() const;
+
+	///Parses whole value to the nodes
+	JSON::PNode toNode(JSON::IFactory &factory) const;
+
+protected:
+	ConstStrA text;
+};
+
+template<> struct FieldTypeConv<JsonText> {static JsonText convert(const FieldContent &f);};
+
+}
+
+#endif /* LIGHTMYSQL_JSONTEXT_H_ */
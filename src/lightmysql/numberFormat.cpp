@@ -0,0 +1,74 @@
+/*
+ * numberFormat.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "numberFormat.h"
+#include <stdio.h>
+#include <stdlib.h>
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+#include <lightspeed/base/containers/autoArray.tcc>
+
+namespace LightMySQL {
+
+static const char digitPairs[] =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+
+void appendUnsigned(AutoArray<char> &buff, unsigned long long v) {
+	char tmp[24];
+	char *e = tmp + sizeof(tmp);
+	char *p = e;
+	while (v >= 100) {
+		unsigned int idx = (unsigned int)(v % 100) * 2;
+		v /= 100;
+		*--p = digitPairs[idx+1];
+		*--p = digitPairs[idx];
+	}
+	if (v >= 10) {
+		unsigned int idx = (unsigned int)v * 2;
+		*--p = digitPairs[idx+1];
+		*--p = digitPairs[idx];
+	} else {
+		*--p = (char)('0' + v);
+	}
+	buff.append(ConstStrA(p, e - p));
+}
+
+void appendSigned(AutoArray<char> &buff, long long v) {
+	if (v < 0) {
+		buff.add('-');
+		appendUnsigned(buff, 0ULL - (unsigned long long)v);
+	} else {
+		appendUnsigned(buff, (unsigned long long)v);
+	}
+}
+
+void appendDouble(AutoArray<char> &buff, double v) {
+	char tmp[40];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	std::to_chars_result r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+	buff.append(ConstStrA(tmp, r.ptr - tmp));
+#else
+	int len = 0;
+	for (int prec = 15; prec <= 17; prec++) {
+		len = snprintf(tmp, sizeof(tmp), "%.*g", prec, v);
+		if (strtod(tmp, 0) == v) break;
+	}
+	buff.append(ConstStrA(tmp, len));
+#endif
+}
+
+}
@@ -0,0 +1,31 @@
+/*
+ * numberFormat.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_NUMBERFORMAT_H_
+#define LIGHTMYSQL_NUMBERFORMAT_H_
+
+#include <lightspeed/base/containers/autoArray.h>
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+///Appends decimal representation of the number
+/** Two digits are converted per step, function doesn't allocate */
+void appendUnsigned(AutoArray<char> &buff, unsigned long long v);
+///Appends decimal representation of the number
+void appendSigned(AutoArray<char> &buff, long long v);
+///Appends the shortest representation which reads back to the same value
+/**
+ * Uses std::to_chars(), when the standard library provides it, otherwise
+ * the shortest of %.15g to %.17g. NaN and infinity are not handled.
+ */
+void appendDouble(AutoArray<char> &buff, double v);
+
+}
+
+#endif /* LIGHTMYSQL_NUMBERFORMAT_H_ */
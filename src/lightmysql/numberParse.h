@@ -0,0 +1,212 @@
+/*
+ * numberParse.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_NUMBERPARSE_H_
+#define LIGHTMYSQL_NUMBERPARSE_H_
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+#include <lightspeed/base/containers/constStr.h>
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+//Parsers of numbers in the text form produced by the server. They are shared
+//by FieldTypeConv and ColumnarResult, so both report invalid format and
+//overflow the same way.
+
+///Reports invalid number
+/**
+ * Kept out of line to keep parsers small
+ * @exception InvalidNumberFormatException always
+ */
+void throwInvalidNumber(ConstStrA txt);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+///Parses 8 decimal digits at once (SWAR)
+/**
+ * @param s pointer to 8 characters
+ * @param out receives value
+ * @retval true parsed
+ * @retval false some character is not a digit
+ */
+inline bool parse8Digits(const char *s, unsigned long long &out) {
+	uint64_t v;
+	memcpy(&v,s,8);
+	//every byte must be in range 0x30-0x39
+	if ((((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)))
+			!= 0x3333333333333333ULL) return false;
+	v = ((v & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+	v = ((v & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+	out = ((v & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+	return true;
+}
+#endif
+
+///Parses unsigned decimal number without sign
+/**
+ * Server formats numbers without spaces and without base prefixes, so
+ * the parser accepts only digits. It doesn't depend on locale.
+ *
+ * @param s begin of the text
+ * @param e end of the text
+ * @param out receives value
+ * @retval true parsed
+ * @retval false invalid character or overflow
+ */
+inline bool parseDigits(const char *s, const char *e, unsigned long long &out) {
+	if (s == e) return false;
+	while (e - s > 1 && *s == '0') ++s;
+	natural len = e - s;
+	//max is 18446744073709551615
+	static const char maxValue[] = "18446744073709551615";
+	if (len > 20 || (len == 20 && memcmp(s,maxValue,20) > 0)) {
+		//can be overflow, or invalid character
+		return false;
+	}
+	unsigned long long r = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	while (e - s >= 8) {
+		unsigned long long d;
+		if (!parse8Digits(s,d)) return false;
+		r = r * 100000000ULL + d;
+		s += 8;
+	}
+#endif
+	while (s != e) {
+		unsigned int d = (unsigned char)*s - '0';
+		if (d > 9) return false;
+		r = r * 10 + d;
+		++s;
+	}
+	out = r;
+	return true;
+}
+
+///Parses integer field
+/**
+ * @param txt text of the field
+ * @return parsed value. Negative number converted to unsigned type
+ * is wrapped, as strtoul() does. Empty text is zero
+ * @exception InvalidNumberFormatException invalid format or overflow
+ */
+template<typename T>
+inline T parseIntField(ConstStrA txt) {
+	const char *s = txt.data();
+	const char *e = s + txt.length();
+	if (s == e) return 0;
+	bool neg = false;
+	if (*s == '-' || *s == '+') {
+		neg = *s == '-';
+		++s;
+	}
+	unsigned long long u = 0;
+	if (!parseDigits(s,e,u)) throwInvalidNumber(txt);
+	if (neg) {
+		if ((T)-1 < (T)0 && u > 9223372036854775808ULL) throwInvalidNumber(txt);
+		return (T)(0 - u);
+	} else {
+		if ((T)-1 < (T)0 && u > 9223372036854775807ULL) throwInvalidNumber(txt);
+		return (T)u;
+	}
+}
+
+template<typename T> struct FloatLimits;
+///double is exact up to 2^53, powers of ten up to 1e22
+template<> struct FloatLimits<double> {
+	static const unsigned long long maxMantissa = 1ULL << 53;
+	static const int maxExp = 22;
+};
+///float is exact up to 2^24, powers of ten up to 1e10
+template<> struct FloatLimits<float> {
+	static const unsigned long long maxMantissa = 1ULL << 24;
+	static const int maxExp = 10;
+};
+
+///Parses simple decimal number [-]digits[.digits]
+/**
+ * When both the mantissa and the power of ten are exactly representable,
+ * single division gives correctly rounded result (Clinger's fast path).
+ * This covers most of the DECIMAL and FLOAT columns.
+ *
+ * @retval true parsed
+ * @retval false number is not simple, use full parser
+ */
+template<typename T>
+inline bool parseFloatFast(const char *s, const char *e, T &out) {
+	static const T pow10[] = {1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,
+			1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+	bool neg = false;
+	if (s != e && *s == '-') {
+		neg = true;
+		++s;
+	}
+	if (s == e) return false;
+	unsigned long long m = 0;
+	int digits = 0;
+	int frac = -1;
+	bool any = false;
+	for (; s != e; ++s) {
+		unsigned int d = (unsigned char)*s - '0';
+		if (d <= 9) {
+			any = true;
+			m = m * 10 + d;
+			//leading zeros don't count
+			if (m) digits++;
+			if (frac >= 0) frac++;
+			if (digits > 19) return false;
+		} else if (*s == '.' && frac < 0) {
+			frac = 0;
+		} else {
+			return false;
+		}
+	}
+	if (!any) return false;
+	if (frac < 0) frac = 0;
+	if (m > FloatLimits<T>::maxMantissa || frac > FloatLimits<T>::maxExp) return false;
+	T r = (T)m / pow10[frac];
+	out = neg?-r:r;
+	return true;
+}
+
+inline double strToFloat(const char *s, char **endp, double) {return strtod(s,endp);}
+inline float strToFloat(const char *s, char **endp, float) {return strtof(s,endp);}
+
+///Parses floating point field
+/**
+ * @param txt text of the field
+ * @return parsed value
+ * @exception InvalidNumberFormatException invalid format
+ */
+template<typename T>
+inline T parseFloatField(ConstStrA txt) {
+	const char *s = txt.data();
+	const char *e = s + txt.length();
+	T r;
+	if (s == e) return 0;
+	if (parseFloatFast(s,e,r)) return r;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	std::from_chars_result res = std::from_chars(s,e,r);
+	if (res.ec != std::errc() || res.ptr != e) throwInvalidNumber(txt);
+	return r;
+#else
+	//text is terminated by zero
+	char *endp;
+	r = strToFloat(s,&endp,r);
+	if (endp != e) throwInvalidNumber(txt);
+	return r;
+#endif
+}
+
+}
+
+#endif /* LIGHTMYSQL_NUMBERPARSE_H_ */
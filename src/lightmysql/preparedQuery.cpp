@@ -0,0 +1,369 @@
+/*
+ * preparedQuery.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "preparedQuery.h"
+#include "query.h"
+#include <string.h>
+#include "mysql/errmsg.h"
+#include <lightspeed/base/containers/autoArray.tcc>
+#include <lightspeed/base/exceptions/throws.tcc>
+#include <lightspeed/base/memory/smallAlloc.h>
+#include <lightspeed/base/streams/utf.h>
+#include <lightspeed/base/streams/utf.tcc>
+
+namespace LightMySQL {
+
+///minimal size of buffer of each column
+static const unsigned long minColumnBuffer = 64;
+
+PreparedResult::PreparedResult(MYSQL &sql, MYSQL_STMT *stmt, IDebugLog *logObject, bool nativeTypes)
+	:Result(storeResult(sql,stmt,logObject)),stmt(stmt),nativeTypes(nativeTypes)
+{
+	if (cur->resPtr) bindResult(0);
+}
+
+Result::ResultInfo PreparedResult::storeResult(MYSQL &sql, MYSQL_STMT *stmt, IDebugLog *logObject) {
+	ResultInfo nfo;
+	nfo.fieldCount = mysql_stmt_field_count(stmt);
+	if (nfo.fieldCount) {
+		if (mysql_stmt_store_result(stmt) != 0) {
+			if (logObject) logObject->onQueryError(mysql_stmt_error(stmt));
+			throw ServerError_t(THISLOCATION,mysql_stmt_errno(stmt),mysql_stmt_error(stmt));
+		}
+		nfo.resPtr = mysql_stmt_result_metadata(stmt);
+		if (logObject)
+			logObject->onQueryResult(mysql_stmt_num_rows(stmt),nfo.fieldCount,0,0,mysql_warning_count(&sql));
+	} else {
+		nfo.affected = mysql_stmt_affected_rows(stmt);
+		nfo.lastId = mysql_stmt_insert_id(stmt);
+		if (logObject)
+			logObject->onQueryResult(0,0,nfo.affected,nfo.lastId,mysql_warning_count(&sql));
+	}
+	nfo.warnings = mysql_warning_count(&sql);
+	return nfo;
+}
+
+///Retrieves native type of the column, typeText if column is fetched as text
+static NativeField::Type getNativeType(const MYSQL_FIELD &fld) {
+	switch (fld.type) {
+	case MYSQL_TYPE_TINY:
+	case MYSQL_TYPE_SHORT:
+	case MYSQL_TYPE_INT24:
+	case MYSQL_TYPE_LONG:
+	case MYSQL_TYPE_LONGLONG:
+	case MYSQL_TYPE_YEAR:
+		return (fld.flags & UNSIGNED_FLAG)?NativeField::typeUInt:NativeField::typeInt;
+	case MYSQL_TYPE_FLOAT: return NativeField::typeFloat;
+	case MYSQL_TYPE_DOUBLE: return NativeField::typeDouble;
+	case MYSQL_TYPE_DATE:
+	case MYSQL_TYPE_DATETIME:
+	case MYSQL_TYPE_TIMESTAMP: return NativeField::typeDateTime;
+	default: return NativeField::typeText;
+	}
+}
+
+void PreparedResult::bindResult(const unsigned long *lengths) const {
+	natural count = cur->fieldCount;
+	const MYSQL_FIELD *fields = mysql_fetch_fields(cur->resPtr);
+	RefCntPtr<FetchBuffer> fb = new FetchBuffer;
+	fb->natives.resize(count);
+
+	AutoArray<unsigned long, SmallAlloc<32> > sizes;
+	sizes.resize(count);
+	std::size_t total = 0;
+	for (natural i = 0; i < count; i++) {
+		if (nativeTypes) fb->natives(i).type = getNativeType(fields[i]);
+		if (fb->natives[i].type != NativeField::typeText) {
+			sizes(i) = 0;
+			continue;
+		}
+		//max_length is calculated by mysql_stmt_store_result(), because
+		//STMT_ATTR_UPDATE_MAX_LENGTH is set on the statement
+		unsigned long sz = fields[i].max_length;
+		if (lengths && lengths[i] > sz) sz = lengths[i];
+		if (sz < minColumnBuffer) sz = minColumnBuffer;
+		sizes(i) = sz + 1;
+		total += sz + 1;
+	}
+
+	fb->binds.resize(count);
+	fb->row.resize(count);
+	fb->lengths.resize(count);
+	fb->nulls.resize(count);
+	fb->data.resize(total);
+	char *buff = fb->data.data();
+	for (natural i = 0; i < count; i++) {
+		MYSQL_BIND &b = fb->binds(i);
+		NativeField &n = fb->natives(i);
+		memset(&b,0,sizeof(b));
+		b.length = &fb->lengths(i);
+		b.is_null = &fb->nulls(i);
+		switch (n.type) {
+		case NativeField::typeInt:
+		case NativeField::typeUInt:
+			b.buffer_type = MYSQL_TYPE_LONGLONG;
+			b.buffer = &n.value.i;
+			b.is_unsigned = n.type == NativeField::typeUInt;
+			break;
+		case NativeField::typeFloat:
+			b.buffer_type = MYSQL_TYPE_FLOAT;
+			b.buffer = &n.value.f;
+			break;
+		case NativeField::typeDouble:
+			b.buffer_type = MYSQL_TYPE_DOUBLE;
+			b.buffer = &n.value.d;
+			break;
+		case NativeField::typeDateTime:
+			b.buffer_type = fields[i].type;
+			b.buffer = &n.time;
+			break;
+		default:
+			b.buffer_type = MYSQL_TYPE_STRING;
+			b.buffer = buff;
+			b.buffer_length = sizes[i];
+			buff += sizes[i];
+			break;
+		}
+	}
+	if (mysql_stmt_bind_result(stmt,fb->binds.data()) != 0)
+		throw ServerError_t(THISLOCATION,mysql_stmt_errno(stmt),mysql_stmt_error(stmt));
+	fetchBuffer = fb;
+}
+
+void PreparedResult::loadNextRow() const {
+	checkResult(THISLOCATION);
+	readyRow = 0;
+	if (fetchBuffer == nil) return;
+	int rc = mysql_stmt_fetch(stmt);
+	if (rc == MYSQL_NO_DATA) return;
+	if (rc == 1)
+		throw ServerError_t(THISLOCATION,mysql_stmt_errno(stmt),mysql_stmt_error(stmt));
+	if (rc == MYSQL_DATA_TRUNCATED) {
+		//some value doesn't fit to the buffer - enlarge buffers and fetch columns again
+		AutoArray<unsigned long, SmallAlloc<32> > lengths;
+		for (natural i = 0; i < fetchBuffer->lengths.length(); i++)
+			lengths.add(fetchBuffer->lengths[i]);
+		bindResult(lengths.data());
+		for (natural i = 0; i < lengths.length(); i++) {
+			if (mysql_stmt_fetch_column(stmt,&fetchBuffer->binds(i),i,0) != 0)
+				throw ServerError_t(THISLOCATION,mysql_stmt_errno(stmt),mysql_stmt_error(stmt));
+		}
+	}
+	FetchBuffer &fb = *fetchBuffer;
+	for (natural i = 0; i < fb.row.length(); i++) {
+		fb.row(i) = fb.nulls[i]?0:static_cast<char *>(fb.binds[i].buffer);
+		fb.natives(i).invalidate();
+	}
+	readyRow = fb.row.data();
+	readyLengths = fb.lengths.data();
+	readyNatives = nativeTypes?fb.natives.data():0;
+}
+
+void PreparedResult::rewind() {
+	if (!noTableResult()) mysql_stmt_data_seek(stmt,0);
+	readyRow = 0;
+}
+
+MYSQL_ROW_OFFSET PreparedResult::tell() const {
+	if (noTableResult()) return 0;
+	return mysql_stmt_row_tell(stmt);
+}
+
+void PreparedResult::seek(MYSQL_ROW_OFFSET rc) {
+	if (!noTableResult() && rc != 0) mysql_stmt_row_seek(stmt,rc);
+	readyRow = 0;
+}
+
+void PreparedResult::seekRow(natural i) {
+	if (i >= countRows())
+		LightSpeed::throwRangeException_To(THISLOCATION,countRows(),i);
+	mysql_stmt_data_seek(stmt,i);
+	readyRow = 0;
+}
+
+natural PreparedResult::countRows() const {
+	if (noTableResult()) return 0;
+	return mysql_stmt_num_rows(stmt);
+}
+
+
+PreparedQuery::PreparedQuery(Connection &conn)
+	:conn(conn),cache(0),stmt(0),session(0),nativeTypes(false) {}
+
+PreparedQuery::PreparedQuery(Connection &conn, StatementCache &cache)
+	:conn(conn),cache(&cache),stmt(0),session(0),nativeTypes(false) {}
+
+PreparedQuery::~PreparedQuery() {
+	closeStatement();
+}
+
+PreparedQuery &PreparedQuery::operator()(ConstStrA queryText) {
+	clear();
+	if (queryText == pattern.getPattern()) return *this;
+	closeStatement();
+	pattern.compile(queryText);
+	stmtText.clear();
+	bindOrder.clear();
+	for (std::size_t i = 0; i < pattern.getSegmentCount(); i++) {
+		stmtText.append(pattern.getLiteral(i));
+		std::size_t idx = pattern.getParamIndex(i);
+		if (idx != naturalNull) {
+			stmtText.add('?');
+			bindOrder.add(idx);
+		}
+	}
+	return *this;
+}
+
+void PreparedQuery::clear() {
+	params.clear();
+	paramData.clear();
+}
+
+void PreparedQuery::closeStatement() {
+	//statements of the cache are closed by the cache
+	if (stmt && !cache) mysql_stmt_close(stmt);
+	stmt = 0;
+}
+
+void PreparedQuery::prepare() {
+	closeStatement();
+	if (cache) {
+		stmt = cache->get(stmtText);
+		session = conn.getSessionCounter();
+		return;
+	}
+	MYSQL *sql = &conn.conn;
+	stmt = mysql_stmt_init(sql);
+	if (stmt == 0)
+		throw ServerError_t(THISLOCATION,mysql_errno(sql),mysql_error(sql));
+	MyBool updateMaxLength = 1;
+	mysql_stmt_attr_set(stmt,STMT_ATTR_UPDATE_MAX_LENGTH,&updateMaxLength);
+	if (mysql_stmt_prepare(stmt,stmtText.data(),stmtText.length()) != 0) {
+		IDebugLog *log = conn.getLogObject();
+		if (log) log->onQueryError(mysql_stmt_error(stmt));
+		throwStmtError(THISLOCATION);
+	}
+	session = conn.getSessionCounter();
+}
+
+void PreparedQuery::throwStmtError(const ProgramLocation &loc) {
+	unsigned int err = mysql_stmt_errno(stmt);
+	StringA msg = mysql_stmt_error(stmt);
+	if (cache) {
+		cache->remove(stmtText);
+		stmt = 0;
+	} else {
+		closeStatement();
+	}
+	//connection lost - let the connection handle the state
+	if (err == CR_SERVER_GONE_ERROR || err == CR_SERVER_LOST)
+		conn.handleError(loc);
+	throw ServerError_t(loc,err,msg);
+}
+
+PreparedResult PreparedQuery::exec() {
+	if (pattern.getPattern().empty())
+		throw EmptyQueryException_t(THISLOCATION);
+	if (!conn.isConnected())
+		throw ServerError_t(THISLOCATION,2006,"mysql is disconnected");
+	conn.checkIdle(THISLOCATION);
+	//cache can evict the statement anytime, so it must be retrieved again
+	if (cache || stmt == 0 || session != conn.getSessionCounter())
+		prepare();
+
+	std::size_t cnt = bindOrder.length();
+	binds.resize(cnt);
+	for (std::size_t i = 0; i < cnt; i++) {
+		std::size_t idx = bindOrder[i];
+		if (idx < 1 || idx > params.length())
+			throw UnassignedQueryParameterException_t(THISLOCATION,pattern.getPattern(),idx);
+		const Param &p = params[idx-1];
+		MYSQL_BIND &b = binds(i);
+		memset(&b,0,sizeof(b));
+		b.buffer_type = p.type;
+		b.buffer = paramData.data() + p.offset;
+		b.buffer_length = p.length;
+		b.is_unsigned = p.isUnsigned;
+	}
+
+	IDebugLog *log = conn.getLogObject();
+	if (log) log->onQueryExec(stmtText);
+	mysql_stmt_free_result(stmt);
+	bool failed = mysql_stmt_bind_param(stmt,binds.data()) != 0
+			|| mysql_stmt_execute(stmt) != 0;
+	clear();
+	if (failed) {
+		if (log) log->onQueryError(mysql_stmt_error(stmt));
+		throwStmtError(THISLOCATION);
+	}
+	PreparedResult res(conn.conn,stmt,log,nativeTypes);
+	//cache must not close the statement while the result reads it
+	if (cache) res.pin = cache->pin(stmtText);
+	return res;
+}
+
+PreparedQuery &PreparedQuery::addParam(enum_field_types type, bool isUnsigned,
+		const void *data, std::size_t length) {
+	//keep numbers aligned, client library reads them directly
+	std::size_t offset = (paramData.length() + 7) & ~(std::size_t)7;
+	paramData.resize(offset + length);
+	if (length) memcpy(paramData.data() + offset, data, length);
+	params.add(Param(type,isUnsigned,offset,length));
+	return *this;
+}
+
+PreparedQuery &PreparedQuery::addInt(long long v) {
+	return addParam(MYSQL_TYPE_LONGLONG,false,&v,sizeof(v));
+}
+
+PreparedQuery &PreparedQuery::addUInt(unsigned long long v) {
+	return addParam(MYSQL_TYPE_LONGLONG,true,&v,sizeof(v));
+}
+
+PreparedQuery &PreparedQuery::arg(ConstStrA str) {
+	return addParam(MYSQL_TYPE_STRING,false,str.data(),str.length());
+}
+
+PreparedQuery &PreparedQuery::arg(ConstStrW str) {
+	AutoArray<char,SmallAlloc<256> > buff;
+	WideToUtf8Reader<ConstStrW::Iterator> iter(str.getFwIter());
+	while (iter.hasItems()) {
+		buff.add(iter.getNext());
+	}
+	return arg(ConstStrA(buff));
+}
+
+PreparedQuery &PreparedQuery::arg(ConstBin str) {
+	return addParam(MYSQL_TYPE_BLOB,false,str.data(),str.length());
+}
+
+PreparedQuery &PreparedQuery::arg(int i) {return addInt(i);}
+PreparedQuery &PreparedQuery::arg(unsigned int i) {return addUInt(i);}
+PreparedQuery &PreparedQuery::arg(long i) {return addInt(i);}
+PreparedQuery &PreparedQuery::arg(unsigned long i) {return addUInt(i);}
+PreparedQuery &PreparedQuery::arg(long long i) {return addInt(i);}
+PreparedQuery &PreparedQuery::arg(unsigned long long i) {return addUInt(i);}
+
+PreparedQuery &PreparedQuery::arg(double val) {
+	return addParam(MYSQL_TYPE_DOUBLE,false,&val,sizeof(val));
+}
+
+PreparedQuery &PreparedQuery::arg(const MYSQL_TIME &val) {
+	return addParam(MYSQL_TYPE_DATETIME,false,&val,sizeof(val));
+}
+
+PreparedQuery &PreparedQuery::arg(const TimeStamp &val) {
+	StringA txt = val.formatTime(ConstStrA("%Y-%m-%d %H:%M:%S"));
+	return arg(ConstStrA(txt));
+}
+
+PreparedQuery &PreparedQuery::null() {
+	return addParam(MYSQL_TYPE_NULL,false,0,0);
+}
+
+}
@@ -0,0 +1,287 @@
+/*
+ * preparedQuery.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_PREPAREDQUERY_H_
+#define LIGHTMYSQL_PREPAREDQUERY_H_
+
+#include <lightspeed/base/containers/autoArray.h>
+#include <lightspeed/base/memory/refCntPtr.h>
+#include <lightspeed/base/timestamp.h>
+#include "compiledQuery.h"
+#include "result.h"
+#include "statementCache.h"
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+#if MYSQL_VERSION_ID >= 80001 && !defined(LIBMARIADB)
+typedef bool MyBool;
+#else
+typedef my_bool MyBool;
+#endif
+
+class PreparedQuery;
+
+///Result of the PreparedQuery
+/**
+ * Object is iterated the same way as Result. Rows are fetched from the
+ * statement using mysql_stmt_fetch(). Whole result is stored at the client
+ * side (mysql_stmt_store_result()), so countRows(), seek() and rewind()
+ * are supported.
+ *
+ * If the native types are enabled, numbers and dates are fetched in the binary
+ * form and FieldContent::as() converts them without parsing the text. Text
+ * form of such fields is created when the field is accessed, so the content
+ * of the field seen by FieldTypeConv is always text.
+ *
+ * @note Unlike to the Result, the row returned by getNext() is valid until
+ * next row is fetched. Whole result is valid until the statement is executed
+ * again or it is closed. Statement shared through the StatementCache is not
+ * evicted while the result exists.
+ *
+ * @note Object cannot be converted to the Result, the Result would read rows
+ * from the metadata of the statement. Use freeze() to get rows which can be
+ * passed to other objects.
+ */
+class PreparedResult: protected Result {
+public:
+
+	using Result::Row;
+	using Result::RangeIter;
+	using Result::hasResult;
+	using Result::nextResult;
+	using Result::firstResult;
+	using Result::hasItems;
+	using Result::getNext;
+	using Result::getAffectedRows;
+	using Result::getInsertId;
+	using Result::getWarningCount;
+	using Result::getFieldCount;
+	using Result::getError;
+	using Result::getErrNo;
+	using Result::isError;
+	using Result::throwErrorException;
+	using Result::noTableResult;
+	using Result::empty;
+	using Result::countFields;
+	using Result::getFieldName;
+	using Result::getFieldIndex;
+	using Result::getFieldInfo;
+	using Result::begin;
+	using Result::end;
+	using Result::freeze;
+	using Result::row;
+
+	virtual void rewind();
+	virtual MYSQL_ROW_OFFSET tell() const;
+	virtual void seek(MYSQL_ROW_OFFSET rc);
+	virtual natural countRows() const;
+
+protected:
+
+	///buffers receiving values of the current row
+	class FetchBuffer: public RefCntObj {
+	public:
+		AutoArray<MYSQL_BIND> binds;
+		AutoArray<char *> row;
+		AutoArray<unsigned long> lengths;
+		AutoArray<MyBool> nulls;
+		AutoArray<NativeField> natives;
+		AutoArray<char> data;
+	};
+
+	PreparedResult(MYSQL &sql, MYSQL_STMT *stmt, IDebugLog *logObject, bool nativeTypes);
+
+	static ResultInfo storeResult(MYSQL &sql, MYSQL_STMT *stmt, IDebugLog *logObject);
+	///binds result columns to the buffers
+	/**
+	 * @param lengths if not NULL, contains minimal size of each buffer
+	 */
+	void bindResult(const unsigned long *lengths) const;
+
+	virtual void loadNextRow() const;
+	virtual bool stableRows() const {return false;}
+	virtual void seekRow(natural i);
+
+	MYSQL_STMT *stmt;
+	///buffers are replaced by loadNextRow(), when a value doesn't fit
+	mutable RefCntPtr<FetchBuffer> fetchBuffer;
+	///keeps the cached statement alive while the result exists
+	StatementCache::PPin pin;
+	bool nativeTypes;
+
+	friend class PreparedQuery;
+};
+
+
+///Query executed as server-side prepared statement
+/**
+ * Object uses the same pattern syntax as Query, however every %N is
+ * translated to the '?' placeholder and the statement is prepared by
+ * the server (mysql_stmt_prepare()). The statement is prepared once and
+ * executed repeatedly while the pattern is not changed. Arguments are
+ * sent in the binary form, they are not escaped and the server
+ * doesn't parse the query again.
+ *
+ * @code
+ * PreparedQuery q(conn);
+ * q("SELECT name FROM users WHERE id=%1");
+ * for (...) {
+ *    PreparedResult res = q.arg(id).exec();
+ *    ...
+ * }
+ * @endcode
+ *
+ * @note Placeholders can be used only at places where the server
+ * accepts a value. Table and field names cannot be supplied as arguments.
+ * The same %N can be used multiple times.
+ */
+class PreparedQuery {
+public:
+
+	///Construct query object
+	/**
+	 * @param conn opened database connection
+	 */
+	PreparedQuery(Connection &conn);
+	///Construct query object which shares statements through the cache
+	/**
+	 * @param conn opened database connection
+	 * @param cache cache of the statements of the connection. Statements are
+	 * owned by the cache, so the result is valid until the next
+	 * execution through the same cache.
+	 */
+	PreparedQuery(Connection &conn, StatementCache &cache);
+	///Destructor - closes the statement
+	~PreparedQuery();
+
+	///Sets new query pattern
+	/**
+	 * @param pattern new query pattern. If the pattern is same as
+	 * current one, already prepared statement is kept
+	 * @return reference to this object allowing to create chains
+	 * @note setting query pattern removes arguments
+	 */
+	PreparedQuery &operator()(ConstStrA pattern);
+
+	///Executes the statement
+	/**
+	 * @return result of the statement
+	 */
+	PreparedResult exec();
+
+	///Removes all arguments
+	void clear();
+
+	///Enables fetching numbers and dates in the native form
+	/**
+	 * @param enable true to fetch integers, floating point numbers and dates
+	 * in the binary form. Conversion to numbers and TimeStamp is then only
+	 * a load of the value. Text form of such value is formatted on request
+	 * and it can differ from the server's formatting (for example
+	 * precision of floating point numbers). Default is false
+	 */
+	void setNativeTypes(bool enable) {nativeTypes = enable;}
+	///Returns true, if native types are enabled
+	bool getNativeTypes() const {return nativeTypes;}
+
+	///feed by argument
+	PreparedQuery &arg(ConstStrA str);
+	///feed by argument
+	PreparedQuery &arg(ConstStrW str);
+	///feed by argument (as binary string)
+	PreparedQuery &arg(ConstBin str);
+	///feed by argument
+	PreparedQuery &arg(int i);
+	///feed by argument
+	PreparedQuery &arg(unsigned int i);
+	///feed by argument
+	PreparedQuery &arg(long i);
+	///feed by argument
+	PreparedQuery &arg(unsigned long i);
+	///feed by argument
+	PreparedQuery &arg(long long i);
+	///feed by argument
+	PreparedQuery &arg(unsigned long long i);
+	///feed by argument
+	PreparedQuery &arg(double val);
+	///feed by argument - date and time in binary form
+	PreparedQuery &arg(const MYSQL_TIME &val);
+	///feed by argument - date and time is sent as DATETIME string
+	PreparedQuery &arg(const TimeStamp &val);
+	///feed by NULL
+	PreparedQuery &null();
+
+	///feed by operator <<
+	template<typename T>
+	PreparedQuery &operator << (const T &v) {return arg(v);}
+
+	///Depends on first argument, function supplies specified value or NULL
+	template<typename T>
+	PreparedQuery &arg_null(bool notnull, const T &val) {
+		if (notnull) return arg(val);
+		else return null();
+	}
+
+	///Returns query pattern
+	ConstStrA getQueryText() const {return pattern.getPattern();}
+	///Returns query sent to the server (with '?' placeholders)
+	ConstStrA getStatementText() const {return stmtText;}
+
+	Connection &getConnection() {return conn;}
+
+protected:
+
+	struct Param {
+		enum_field_types type;
+		bool isUnsigned;
+		///offset in paramData
+		std::size_t offset;
+		std::size_t length;
+
+		Param(enum_field_types type, bool isUnsigned, std::size_t offset, std::size_t length)
+			:type(type),isUnsigned(isUnsigned),offset(offset),length(length) {}
+	};
+
+	Connection &conn;
+	///cache of statements, NULL if not used
+	StatementCache *cache;
+	///prepared statement, NULL if not prepared
+	MYSQL_STMT *stmt;
+	///session of the connection, where the statement has been prepared
+	natural session;
+	///parsed pattern
+	CompiledQuery pattern;
+	///pattern translated to the statement
+	AutoArray<char> stmtText;
+	///one-based index of argument for every '?' in the statement
+	AutoArray<std::size_t> bindOrder;
+	///arguments
+	AutoArray<Param> params;
+	///values of arguments
+	AutoArray<char> paramData;
+	///binding of arguments
+	AutoArray<MYSQL_BIND> binds;
+	///fetch numbers and dates in the native form
+	bool nativeTypes;
+
+	void prepare();
+	void closeStatement();
+	void throwStmtError(const ProgramLocation &loc);
+	PreparedQuery &addParam(enum_field_types type, bool isUnsigned, const void *data, std::size_t length);
+	PreparedQuery &addInt(long long v);
+	PreparedQuery &addUInt(unsigned long long v);
+
+private:
+	PreparedQuery(const PreparedQuery &other);
+	PreparedQuery &operator=(const PreparedQuery &other);
+};
+
+}
+
+#endif /* LIGHTMYSQL_PREPAREDQUERY_H_ */
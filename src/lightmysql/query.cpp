@@ -14,47 +14,46 @@
 
 #include "query.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <sstream>
 #include "result.h"
+#include "streamResult.h"
+#include "numberFormat.h"
 #include <lightspeed/base/containers/autoArray.tcc>
 #include "lightspeed/base/memory/smallAlloc.h"
 #include <lightspeed/base/streams/utf.h>
 #include <lightspeed/base/streams/utf.tcc>
+#include <lightspeed/base/containers/stringpool.tcc>
+#include <lightspeed/base/containers/map.tcc>
 
 using LightSpeed::SmallAlloc;
 
 
 namespace LightMySQL {
 
-Query::Query(IConnection &conn):conn(conn),commitPos(0),lastCmd(cmdNotSet),executed(0),pairlevel(0) {
+Query::Query(IConnection &conn):conn(conn),commitPos(0),plan(0),lastCmd(cmdNotSet),executed(0),pairlevel(0) {
 
 }
 
-Query::Query(const Query &other):conn(other.conn),lastCmd(cmdNotSet),executed(true),pairlevel(0) {}
+Query::Query(const Query &other):conn(other.conn),commitPos(0),plan(0),lastCmd(cmdNotSet),executed(true),pairlevel(0) {}
 
 Query & Query::arg(long long i)
 {
-	char buff[100];
-	sprintf(buff,"%lld",i);
-	paramBuffer.append(ConstStrA(buff));
+	appendSigned(paramBuffer,i);
 	paramEnds.add(paramBuffer.length());
 	return *this;
 }
 
 Query & Query::arg(unsigned long long i)
 {
-	char buff[100];
-	sprintf(buff,"%llu",i);
-	paramBuffer.append(ConstStrA(buff));
+	appendUnsigned(paramBuffer,i);
 	paramEnds.add(paramBuffer.length());
 	return *this;
 }
 
 Query & Query::arg(int i)
 {
-	char buff[100];
-	sprintf(buff,"%d",i);
-	paramBuffer.append(ConstStrA(buff));
+	appendSigned(paramBuffer,i);
 	paramEnds.add(paramBuffer.length());
 	return *this;
 }
@@ -65,29 +64,12 @@ ConstStrA Query::build() const {
 		queryBuffer.erase(commitPos,queryBuffer.length()-commitPos);
 	else
 		queryBuffer.clear();
-	for (AutoArray<char>::Iterator iter = queryText.getFwIter(); iter.hasItems(); ) {
-
-		char c = iter.getNext();
-		if (c != '%') queryBuffer.add(c);
-		else {
-			if (!iter.hasItems() || iter.peek() == '%') {
-				queryBuffer.add(iter.getNext());
-			} else {
-				std::size_t idx = 0;
-				while (iter.hasItems() && isdigit(iter.peek())) {
-					idx = idx * 10 + ((iter.getNext()) - '0');
-				}
-				if (idx < 1 || idx > paramEnds.length())
-					throw UnassignedQueryParameterException_t(
-							THISLOCATION,queryText,idx);
-				idx--;
-				std::size_t b = idx == 0?0:paramEnds[idx-1];
-				std::size_t e = paramEnds[idx];
-				while (b < e) queryBuffer.add(paramBuffer[b++]);
-
-			}
-		}
+	if (plan == 0) {
+		//pattern composed by append() or by the commands, compiled once
+		scratchPlan.compile(queryText);
+		plan = &scratchPlan;
 	}
+	plan->build(queryBuffer,paramBuffer,paramEnds.data(),paramEnds.length());
 	return queryBuffer;
 }
 
@@ -104,11 +86,39 @@ Result Query::exec()
 
 }
 
+UpdateResult Query::execUpdate()
+{
+	if (queryText.empty())
+		throw EmptyQueryException_t(THISLOCATION);
+	build();
+	paramBuffer.clear();
+	paramEnds.clear();
+	executed = true;
+	lastCmd = cmdNotSet;
+	return conn.executeUpdate(queryBuffer);
+}
+
+StreamResult Query::execStream()
+{
+	if (queryText.empty())
+		throw EmptyQueryException_t(THISLOCATION);
+	Connection *c = conn.getDirectConnection();
+	if (c == 0)
+		throw NoDirectConnectionException_t(THISLOCATION);
+	build();
+	paramBuffer.clear();
+	paramEnds.clear();
+	executed = true;
+	lastCmd = cmdNotSet;
+	return c->executeStream(queryBuffer);
+}
+
 Query &Query::append(ConstStrA queryText) {
 	build();
 	commitPos = queryBuffer.length();
 	this->queryText.clear();
 	this->queryText.append(queryText);
+	plan = 0;
 	paramBuffer.clear();
 	paramEnds.clear();
 	return *this;
@@ -118,7 +128,7 @@ Query &Query::append(ConstStrA queryText) {
 Query & Query::arg(ConstStrA str)
 {
 	paramBuffer.add('\'');
-	paramBuffer.append(conn.escapeString(str));
+	conn.escapeString(str,paramBuffer);
 	paramBuffer.add('\'');
 	paramEnds.add(paramBuffer.length());
 	return *this;
@@ -143,15 +153,26 @@ Query &Query::arg(ConstStrW str)
 
 Query & Query::arg(double val)
 {
-	char buff[100];
-	sprintf(buff,"%g",val);
-	paramBuffer.append(ConstStrA(buff));
+	appendDouble(paramBuffer,val);
 	paramEnds.add(paramBuffer.length());
 	return *this;
 }
 
 Query & Query::operator ()(ConstStrA queryText)
 {
+	setPattern(queryText);
+	plan = cachePlan(queryText);
+	return *this;
+}
+
+Query & Query::operator ()(const CompiledQuery &pattern)
+{
+	setPattern(pattern.getPattern());
+	plan = &pattern;
+	return *this;
+}
+
+void Query::setPattern(ConstStrA queryText) {
 	if (executed) {
 		clear();
 		this->queryText.append(queryText);
@@ -159,33 +180,43 @@ Query & Query::operator ()(ConstStrA queryText)
 		if (commitPos) append(";");
 		append(queryText);
 	}
-	return *this;
+}
+
+void Query::appendPattern(ConstStrA text) {
+	queryText.append(text);
+	//plan no longer matches the pattern
+	plan = 0;
+}
+
+const CompiledQuery *Query::cachePlan(ConstStrA queryText) {
+	const CompiledQuery *p = planCache.find(queryText);
+	if (p) return p;
+	if (planCache.length() >= maxCachedPlans) {
+		planCache.clear();
+		planNames.clear();
+	}
+	planCache.insert(planNames.add(queryText),CompiledQuery(queryText));
+	return planCache.find(queryText);
 }
 
 
 Query & Query::arg(unsigned int i)
 {
-	char buff[100];
-	sprintf(buff,"%u",i);
-	paramBuffer.append(ConstStrA(buff));
+	appendUnsigned(paramBuffer,i);
 	paramEnds.add(paramBuffer.length());
 	return *this;
 }
 
 Query & Query::arg(unsigned long i)
 {
-	char buff[100];
-	sprintf(buff,"%lu",i);
-	paramBuffer.append(ConstStrA(buff));
+	appendUnsigned(paramBuffer,i);
 	paramEnds.add(paramBuffer.length());
 	return *this;
 }
 
 Query & Query::arg(long i)
 {
-	char buff[100];
-	sprintf(buff,"%ld",i);
-	paramBuffer.append(ConstStrA(buff));
+	appendSigned(paramBuffer,i);
 	paramEnds.add(paramBuffer.length());
 	return *this;
 }
@@ -261,7 +292,7 @@ void EmptyQueryException_t::message(LightSpeed::ExceptionMsg & msg) const
 
 
 Query& Query::escaped(ConstStrA str) {
-	paramBuffer.append(conn.escapeString(str));
+	conn.escapeString(str,paramBuffer);
 	paramEnds.add(paramBuffer.length());
 	return *this;
 }
@@ -301,10 +332,16 @@ void Query::clear() {
 	paramEnds.clear();
 	queryBuffer.clear();
 	commitPos = 0;
+	plan = 0;
 	executed = false;
 	lastCmd = cmdNotSet;
 }
 
+void Query::clearArgs() {
+	paramBuffer.clear();
+	paramEnds.clear();
+}
+
 Query& Query::INSERT(ConstStrA pattern) {
 	beginCommand(cmdInsert, "INSERT INTO");
 	append(pattern);
@@ -550,8 +587,8 @@ Query &Query::LIMIT(natural offset,natural count) {
 Query &Query::VALUES(ConstStrA pattern) {
 	beginCommand(cmdValues,"VALUES",",");
 	append("(");
-	this->queryText.append(pattern);
-	this->queryText.append(ConstStrA(")"));
+	appendPattern(pattern);
+	appendPattern(")");
 	return *this;
 
 }
@@ -559,9 +596,9 @@ Query &Query::VALUES(ConstStrA pattern) {
 bool Query::beginCommand(CmdType cmd, ConstStrA cmdName) {
 	if (executed) clear();
 	bool res = cmd != lastCmd;
-	this->queryText.append(ConstStrA(" "));
+	appendPattern(" ");
 	append(res?cmdName:",");
-	this->queryText.append(ConstStrA(" "));
+	appendPattern(" ");
 	lastCmd = cmd;
 	return res;
 }
@@ -574,9 +611,9 @@ Query& Query::end() {
 bool Query::beginCommand(CmdType cmd, ConstStrA cmdName, ConstStrA separator) {
 	if (executed) clear();
 	bool res = cmd != lastCmd;
-	this->queryText.append(ConstStrA(" "));
+	appendPattern(" ");
 	append(res?cmdName:separator);
-	this->queryText.append(ConstStrA(" "));
+	appendPattern(" ");
 	lastCmd = cmd;
 	return res;
 }
@@ -645,6 +682,9 @@ SubQuery::~SubQuery() {
 Result SubQuery::exec() {
 	return leave().exec();
 }
+UpdateResult SubQuery::execUpdate() {
+	return leave().execUpdate();
+}
 Query &SubQuery::leave() {
 	if (active) {
 		append(") %1").raw(suffix);
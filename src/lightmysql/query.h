@@ -20,7 +20,10 @@
 #include "iconnection.h"
 #include <vector>
 #include "exception.h"
+#include "compiledQuery.h"
 #include <lightspeed/base/containers/autoArray.h>
+#include <lightspeed/base/containers/stringpool.h>
+#include <lightspeed/base/containers/map.h>
 #include "lightspeed/base/containers/constStr.h"
 
 
@@ -29,8 +32,11 @@ namespace LightMySQL {
 using namespace LightSpeed;
 
 class Result;
+class StreamResult;
 class SubQuery;
 class CreateTableDef;
+class AsyncReactor;
+class AsyncExec;
 
 
 ///Builds and executes query
@@ -50,6 +56,10 @@ class CreateTableDef;
  *
  * To repeat same query, you can start to feed arguments without
  * need to reset the query pattern
+ *
+ * Patterns set by operator() are parsed once and kept in the object
+ * (see CompiledQuery), so the same pattern executed repeatedly through
+ * the same Query object is not parsed again.
  */
 class Query {
 public:
@@ -72,6 +82,15 @@ public:
 	 */
 	Query &operator()(ConstStrA queryText);
 
+	///Sets new query pattern using already compiled pattern
+	/**
+	 * @param pattern compiled pattern. Object must remain valid until
+	 *  the query is built and executed
+	 * @return reference to this object allowing to create chains
+	 * @note setting query pattern removes arguments
+	 */
+	Query &operator()(const CompiledQuery &pattern);
+
 
 	///Executes the query
 	/**
@@ -79,8 +98,51 @@ public:
 	 */
 	virtual Result exec();
 
+	///Executes statement which doesn't return rows
+	/**
+	 * Faster than exec() for INSERT, UPDATE and DELETE, because the
+	 * Result object is not created
+	 *
+	 * @return count of affected rows, insert id and count of warnings
+	 */
+	virtual UpdateResult execUpdate();
+
+	///Executes the query and streams its result
+	/**
+	 * Rows are read from the server as they are fetched, see StreamResult.
+	 * Connection remains busy until the stream is read or cancelled.
+	 *
+	 * @return streamed result
+	 * @exception NoDirectConnectionException_t query is not bound to
+	 * the Connection (see IConnection::getDirectConnection())
+	 */
+	StreamResult execStream();
+
+#ifdef __cpp_impl_coroutine
+	///Executes the query asynchronously from a coroutine
+	/**
+	 * @code
+	 * Result res = co_await q("SELECT * FROM users WHERE id=%1").arg(id).execAsync(reactor);
+	 * @endcode
+	 *
+	 * The query is built immediately, so the object can be reused while
+	 * the coroutine is suspended.
+	 *
+	 * @param reactor reactor which executes the query
+	 * @return awaitable object, see asyncCoro.h
+	 * @exception NoDirectConnectionException_t query is not bound to
+	 * the Connection (see IConnection::getDirectConnection())
+	 */
+	AsyncExec execAsync(AsyncReactor &reactor);
+#endif
+
 	void clear();
 
+	///Removes all arguments, but keeps the pattern
+	/** Allows to build the same pattern with different arguments without
+	 * need to set the pattern again */
+	void clearArgs();
+
 	///feed by argument
 	/** function escapes and adds quotes */
 	Query &arg(ConstStrA str);
@@ -324,6 +386,26 @@ protected:
 
 	std::size_t commitPos;
 
+	typedef Map<StringPoolA::Str, CompiledQuery> PlanCache;
+	///maximum count of patterns kept in the planCache
+	static const std::size_t maxCachedPlans = 512;
+
+	///compiled pattern of the current queryText, NULL if it must be compiled
+	/** Every change of the queryText resets the pointer, build() compiles
+	 * the pattern into the scratchPlan only once */
+	mutable const CompiledQuery *plan;
+	///used to compile patterns which are not in the cache
+	mutable CompiledQuery scratchPlan;
+	///names of cached patterns
+	StringPoolA planNames;
+	///patterns compiled by operator()
+	PlanCache planCache;
+
+	void setPattern(ConstStrA queryText);
+	const CompiledQuery *cachePlan(ConstStrA queryText);
+	///appends text to the current pattern
+	void appendPattern(ConstStrA text);
+
 	Query &appendArg() {
 		paramEnds.resize(paramEnds.length()-1);
 		return *this;
@@ -472,6 +554,8 @@ public:
 	~SubQuery();
 	///executes query ending all subqueries
 	virtual Result exec();
+	///executes statement ending all subqueries
+	virtual UpdateResult execUpdate();
 	///leaves query appends ) to a query
 	Query &leave();
 	///alias to leave
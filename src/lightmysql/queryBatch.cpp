@@ -0,0 +1,91 @@
+/*
+ * queryBatch.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "queryBatch.h"
+#include "query.h"
+#include "mysql/errmsg.h"
+#include <lightspeed/base/containers/autoArray.tcc>
+#include <lightspeed/base/exceptions/throws.tcc>
+
+namespace LightMySQL {
+
+QueryBatch::QueryBatch(Connection &conn):conn(conn) {}
+
+natural QueryBatch::add(ConstStrA query) {
+	if (!ends.empty()) batch.add(';');
+	batch.append(query);
+	ends.add(batch.length());
+	return ends.length() - 1;
+}
+
+natural QueryBatch::add(const Query &query) {
+	return add(query.build());
+}
+
+ConstStrA QueryBatch::getStatement(natural idx) const {
+	if (idx >= ends.length())
+		throwRangeException_FromTo(THISLOCATION,0,(int)ends.length()-1,(int)idx);
+	natural b = idx?ends[idx-1]+1:0;
+	return ConstStrA(batch.data() + b, ends[idx] - b);
+}
+
+Result &QueryBatch::getResult(natural idx) {
+	if (idx >= results.length())
+		throwRangeException_FromTo(THISLOCATION,0,(int)results.length()-1,(int)idx);
+	return results(idx);
+}
+
+void QueryBatch::clear() {
+	batch.clear();
+	ends.clear();
+	results.clear();
+}
+
+bool QueryBatch::exec() {
+	results.clear();
+	if (ends.empty()) return true;
+	if (!conn.isConnected())
+		throw ServerError_t(THISLOCATION,2006,"mysql is disconnected");
+	conn.checkIdle(THISLOCATION);
+
+	MYSQL &sql = conn.conn;
+	IDebugLog *log = conn.getLogObject();
+	if (log) log->onQueryExec(batch);
+	if (mysql_real_query(&sql,batch.data(),batch.length()) != 0) {
+		unsigned int err = mysql_errno(&sql);
+		if (log) log->onQueryError(mysql_error(&sql));
+		//connection errors are thrown, error of the first statement is reported by its result
+		if (err >= CR_MIN_ERROR && err <= CR_MAX_ERROR) conn.handleError(THISLOCATION);
+		Result::ResultInfo nfo;
+		nfo.myerrno = err;
+		nfo.error = mysql_error(&sql);
+		results.add(Result(nfo));
+		return false;
+	}
+
+	bool ok = true;
+	for(;;) {
+		results.add(Result(Result::readResultInfo(sql,log)));
+		if (results[results.length()-1].isError()) ok = false;
+		if (!mysql_more_results(&sql)) break;
+		if (mysql_next_result(&sql) > 0) {
+			//next statement failed - server doesn't process the rest of the batch
+			unsigned int err = mysql_errno(&sql);
+			if (log) log->onQueryError(mysql_error(&sql));
+			if (err >= CR_MIN_ERROR && err <= CR_MAX_ERROR) conn.handleError(THISLOCATION);
+			Result::ResultInfo nfo;
+			nfo.myerrno = err;
+			nfo.error = mysql_error(&sql);
+			results.add(Result(nfo));
+			ok = false;
+			break;
+		}
+	}
+	return ok && results.length() == ends.length();
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+ * queryBatch.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_QUERYBATCH_H_
+#define LIGHTMYSQL_QUERYBATCH_H_
+
+#include <lightspeed/base/containers/autoArray.h>
+#include "connection.h"
+#include "result.h"
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+class Query;
+
+///Executes multiple independent statements in one round-trip
+/**
+ * Statements are collected by add() and sent to the server as a single
+ * multi-statement query. Every statement receives own Result.
+ *
+ * @code
+ * QueryBatch batch(conn);
+ * natural users = batch.add(q("SELECT COUNT(*) FROM users").build());
+ * natural orders = batch.add(q("SELECT * FROM orders WHERE user=%1").arg(id).build());
+ * batch.exec();
+ * Result &res = batch.getResult(orders);
+ * @endcode
+ *
+ * Server stops processing of the batch at the first failed statement.
+ * Result of the failed statement contains the error (see Result::isError()),
+ * following statements are reported as not executed.
+ *
+ * @note Every statement must produce exactly one result. Don't use
+ * statements which produce multiple results (for example CALL). Statements
+ * should not contain the ';' separator at the end.
+ */
+class QueryBatch {
+public:
+
+	///Constructs the batch
+	/**
+	 * @param conn connection. It must be connected with CLIENT_MULTI_STATEMENTS
+	 * (which is the default)
+	 */
+	QueryBatch(Connection &conn);
+
+	///Adds statement
+	/**
+	 * @param query built query
+	 * @return index of the statement
+	 */
+	natural add(ConstStrA query);
+	///Adds statement
+	/**
+	 * @param query query object, the query is built and the object can be reused
+	 * @return index of the statement
+	 */
+	natural add(const Query &query);
+
+	///Executes all statements
+	/**
+	 * @retval true all statements succeeded
+	 * @retval false some statement failed, check results
+	 * @exception ServerError_t connection error
+	 */
+	bool exec();
+
+	///Removes all statements and results
+	void clear();
+
+	///Retrieves count of the statements
+	natural size() const {return ends.length();}
+
+	///Retrieves whether the statement has been executed
+	/**
+	 * @param idx index of the statement
+	 * @retval true executed (successfully or with an error)
+	 * @retval false not executed, because previous statement failed
+	 */
+	bool isExecuted(natural idx) const {return idx < results.length();}
+
+	///Retrieves result of the statement
+	/**
+	 * @param idx index of the statement
+	 * @return result of the statement
+	 * @exception RangeException statement has not been executed
+	 */
+	Result &getResult(natural idx);
+
+	///Retrieves count of affected rows of the statement
+	my_ulonglong getAffectedRows(natural idx) {return getResult(idx).getAffectedRows();}
+
+	///Retrieves text of the statement
+	ConstStrA getStatement(natural idx) const;
+
+	Connection &getConnection() {return conn;}
+
+protected:
+
+	Connection &conn;
+	///statements separated by ';'
+	AutoArray<char> batch;
+	///end of each statement in the batch
+	AutoArray<natural> ends;
+	///results of executed statements
+	AutoArray<Result> results;
+
+private:
+	QueryBatch(const QueryBatch &other);
+	QueryBatch &operator=(const QueryBatch &other);
+};
+
+}
+
+#endif /* LIGHTMYSQL_QUERYBATCH_H_ */
@@ -90,11 +90,17 @@ void MasterSlavePool::init(const MySQLConfig& cfg, unsigned long flags) {
 bool Resource::expired() const {
 
 	if (AbstractResource::expired()) return true;
+	//connection with an open stream cannot be used by other user
+	if (isStreaming()) return true;
 
 	const IConnection &conn = q.getConnection();
 	return !conn.isConnected();
 
 }
 
+void Resource::onSessionClosed() {
+	stmtCache.clear();
+}
+
 } /* namespace jsonsrv */
 
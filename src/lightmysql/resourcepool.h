@@ -12,6 +12,7 @@
 #include "connection.h"
 #include "query.h"
 #include "transaction.h"
+#include "statementCache.h"
 
 namespace LightSpeed {
 class IniConfig;
@@ -24,7 +25,7 @@ class Resource: public AbstractResource, public Connection {
 public:
 
 	///construct mysql resource
-	Resource():q(*this) {}
+	Resource():q(*this),stmtCache(*this) {}
 
 	///Retrieve transaction object
 	/** You should use transaction object for most of the
@@ -43,11 +44,24 @@ public:
 	 * @return reference to the query object
 	 */
 	Query &getQueryObject() {return q;}
+	///Retrieve cache of prepared statements
+	/** Cache keeps statements prepared on this connection. Pass it to
+	 * the PreparedQuery to reuse statements between the queries
+	 *
+	 * @return reference to the cache
+	 */
+	StatementCache &getStatementCache() {return stmtCache;}
 
+	///Determines, whether the resource can be reused
+	/** Resource is also expired when it is returned with an open
+	 * StreamResult. Such connection is closed instead of being reused */
 	virtual bool expired() const;
 
 protected:
 	Query q;
+	StatementCache stmtCache;
+
+	virtual void onSessionClosed();
 private:
 	Resource(const Resource &other);
 	Resource &operator=(const Resource &other);
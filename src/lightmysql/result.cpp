@@ -15,6 +15,7 @@
 #include "result.h"
 #include <string.h>
 #include <lightspeed/base/exceptions/throws.tcc>
+#include <lightspeed/base/containers/autoArray.tcc>
 //#include <lightspeed/base/text/textOut.tcc>
 #include <memory>
 
@@ -31,7 +32,7 @@ Result::~Result() {
 Result::ResultInfo::~ResultInfo() {
 	if (!isShared())
 		//free mysql result, if not shared
-		if (resPtr) mysql_free_result(resPtr);
+		if (resPtr && ownsRes) mysql_free_result(resPtr);
 }
 
 
@@ -44,34 +45,7 @@ Result::Result(MYSQL & sql, IDebugLog *logObject)
 	bool nextRes = true;
 	while (nextRes) {
 
-		ResultInfo nfo;
-
-		MYSQL_RES *res = mysql_store_result(&sql);
-		if (res == 0) {
-
-			if ((nfo.myerrno = mysql_errno(&sql))!=0) {
-				nfo.error = mysql_error(&sql);
-				if (logObject) logObject->onQueryError(nfo.error);
-			} else if ((nfo.fieldCount = mysql_field_count(&sql)) == 0) {
-				nfo.affected = mysql_affected_rows(&sql);
-				nfo.lastId = mysql_insert_id(&sql);
-				if (logObject) {
-					const char *info = mysql_info(&sql);
-					if (info) logObject->onQueryInfo(info);
-					logObject->onQueryResult(0,0,nfo.affected,nfo.lastId,mysql_warning_count(&sql));
-				}
-			}
-		} else {
-			nfo.resPtr = res;
-			nfo.fieldCount = mysql_field_count(&sql);
-			if (logObject) {
-				const char *info = mysql_info(&sql);
-				if (info) logObject->onQueryInfo(info);
-				logObject->onQueryResult(mysql_num_rows(res),nfo.fieldCount,0,0,mysql_warning_count(&sql));
-			}
-		}
-
-		nfo.warnings = mysql_warning_count(&sql);
+		ResultInfo nfo = readResultInfo(sql,logObject);
 		result->push_back(nfo);
 
 		nextRes = mysql_more_results(&sql) != 0;
@@ -91,11 +65,66 @@ Result::Result(MYSQL & sql, IDebugLog *logObject)
 	tmp.release();
 }
 
+Result::ResultInfo Result::readResultInfo(MYSQL &sql, IDebugLog *logObject) {
+	return makeResultInfo(sql,mysql_store_result(&sql),logObject);
+}
+
+Result::ResultInfo Result::makeResultInfo(MYSQL &sql, MYSQL_RES *res, IDebugLog *logObject) {
+	ResultInfo nfo;
+
+	if (res == 0) {
+
+		if ((nfo.myerrno = mysql_errno(&sql))!=0) {
+			nfo.error = mysql_error(&sql);
+			if (logObject) logObject->onQueryError(nfo.error);
+		} else if ((nfo.fieldCount = mysql_field_count(&sql)) == 0) {
+			nfo.affected = mysql_affected_rows(&sql);
+			nfo.lastId = mysql_insert_id(&sql);
+			if (logObject) {
+				const char *info = mysql_info(&sql);
+				if (info) logObject->onQueryInfo(info);
+				logObject->onQueryResult(0,0,nfo.affected,nfo.lastId,mysql_warning_count(&sql));
+			}
+		}
+	} else {
+		nfo.resPtr = res;
+		nfo.fieldCount = mysql_field_count(&sql);
+		if (logObject) {
+			const char *info = mysql_info(&sql);
+			if (info) logObject->onQueryInfo(info);
+			logObject->onQueryResult(mysql_num_rows(res),nfo.fieldCount,0,0,mysql_warning_count(&sql));
+		}
+	}
+
+	nfo.warnings = mysql_warning_count(&sql);
+	return nfo;
+}
+
+Result::Result(const ResultInfo &nfo)
+{
+	std::auto_ptr<ResultList_t> tmp(new ResultList_t);
+	result = tmp.get();
+	result->push_back(nfo);
+	cur = result->begin();
+	initResult();
+	tmp.release();
+}
+
+Result::Result(ResultList_t &list)
+{
+	std::auto_ptr<ResultList_t> tmp(new ResultList_t);
+	result = tmp.get();
+	result->splice(result->end(),list);
+	cur = result->begin();
+	initResult();
+	tmp.release();
+}
+
 void Result::freeResult()
 {
 	for (ResultList_t::iterator iter = result->begin();
 			iter != result->end();iter++)
-		mysql_free_result(iter->resPtr);
+		if (iter->ownsRes) mysql_free_result(iter->resPtr);
 	result->clear();
 }
 
@@ -105,6 +134,8 @@ void Result::initResult() {
 		firstRow = mysql_row_tell(cur->resPtr);
 	}
 	readyRow = 0;
+	readyLengths = 0;
+	readyNatives = 0;
 }
 
 bool Result::hasResult() const {
@@ -141,13 +172,23 @@ Result::Row Result::getNext() {
 	};
 
 	Unset_t unset(&readyRow);
-	return Row(*this,readyRow,mysql_fetch_lengths(cur->resPtr),mysql_num_fields(cur->resPtr));
+	return Row(*this,readyRow,readyLengths,mysql_num_fields(cur->resPtr),readyNatives);
+}
+
+bool Result::takeRow(MYSQL_ROW &row, const unsigned long *&lengths, const NativeField *&natives) {
+	if (!hasItems()) return false;
+	row = readyRow;
+	lengths = readyLengths;
+	natives = readyNatives;
+	readyRow = 0;
+	return true;
 }
 
 void Result::loadNextRow() const {
 	checkResult(THISLOCATION);
 	if (cur->resPtr) {
 		readyRow = mysql_fetch_row(cur->resPtr);
+		readyLengths = readyRow?mysql_fetch_lengths(cur->resPtr):0;
 	} else {
 		readyRow = 0;
 	}
@@ -242,6 +283,136 @@ const MYSQL_FIELD *Result::getFieldInfo(std::size_t i) const {
 	return mysql_fetch_field_direct(cur->resPtr,i);
 }
 
+static inline natural hashFieldName(ConstStrA name) {
+	//FNV-1a
+	natural h = 2166136261U;
+	for (natural i = 0; i < name.length(); i++) {
+		h ^= (unsigned char)name[i];
+		h *= 16777619U;
+	}
+	return h;
+}
+
+void Result::NameIndex::build(MYSQL_RES *res, natural count) {
+	names.clear();
+	slots.clear();
+	for (natural i = 0; i < count; i++) {
+		const MYSQL_FIELD *f = mysql_fetch_field_direct(res,i);
+		names.add(ConstStrA(f->name,f->name_length));
+	}
+	//keep the table at most half full
+	natural sz = 8;
+	while (sz < count * 2) sz <<= 1;
+	for (natural i = 0; i < sz; i++) slots.add(0);
+	natural mask = sz - 1;
+	for (natural i = 0; i < count; i++) {
+		natural h = hashFieldName(names[i]) & mask;
+		while (slots[h]) h = (h + 1) & mask;
+		slots(h) = i + 1;
+	}
+}
+
+natural Result::NameIndex::find(ConstStrA name) const {
+	if (slots.empty()) return naturalNull;
+	natural mask = slots.length() - 1;
+	natural h = hashFieldName(name) & mask;
+	while (slots[h]) {
+		natural idx = slots[h] - 1;
+		if (names[idx] == name) return idx;
+		h = (h + 1) & mask;
+	}
+	return naturalNull;
+}
+
+const Result::NameIndex &Result::getNameIndex() const {
+	checkResult(THISLOCATION);
+	if (cur->nameIndex.empty() && cur->resPtr && cur->fieldCount)
+		cur->nameIndex.build(cur->resPtr,cur->fieldCount);
+	return cur->nameIndex;
+}
+
+natural Result::getFieldIndex(ConstStrA name) const {
+	return getNameIndex().find(name);
+}
+
+const Result::RowIndex &Result::getRowIndex() const {
+	checkResult(THISLOCATION);
+	RowIndex &idx = cur->rowIndex;
+	if (!idx.built && cur->resPtr) {
+		MYSQL_RES *res = cur->resPtr;
+		natural cnt = mysql_num_fields(res);
+		//reading position must be kept
+		MYSQL_ROW_OFFSET save = mysql_row_tell(res);
+		mysql_data_seek(res,0);
+		MYSQL_ROW r;
+		while ((r = mysql_fetch_row(res)) != 0) {
+			const unsigned long *l = mysql_fetch_lengths(res);
+			idx.rows.add(r);
+			for (natural i = 0; i < cnt; i++) idx.lengths.add(l[i]);
+		}
+		mysql_row_seek(res,save);
+		idx.built = true;
+		//lengths of the prepared row has been overwritten, use the index
+		if (readyRow) {
+			for (natural i = 0; i < idx.rows.length(); i++)
+				if (idx.rows[i] == readyRow) {
+					readyLengths = const_cast<unsigned long *>(idx.lengths.data()) + i * cnt;
+					break;
+				}
+		}
+	}
+	return idx;
+}
+
+Result::Row Result::indexedRow(const RowIndex &idx, natural i) {
+	natural cnt = cur->fieldCount;
+	return makeRow(idx.rows[i],const_cast<unsigned long *>(idx.lengths.data()) + i * cnt);
+}
+
+natural Result::prepareRows() {
+	if (!stableRows()) return naturalNull;
+	const RowIndex &idx = getRowIndex();
+	getNameIndex();
+	return idx.rows.length();
+}
+
+Result::Row Result::rowAt(natural i) {
+	return indexedRow(cur->rowIndex,i);
+}
+
+void Result::seekRow(natural i) {
+	rewind();
+	for (natural j = 0; j < i; j++) {
+		if (!hasItems()) LightSpeed::throwRangeException_To(THISLOCATION,j,i);
+		readyRow = 0;
+	}
+}
+
+Result::Row Result::row(natural i) {
+	if (noTableResult()) LightSpeed::throwRangeException_To(THISLOCATION,(natural)0,i);
+	natural rows = prepareRows();
+	if (rows != naturalNull) {
+		if (i >= rows)
+			LightSpeed::throwRangeException_To(THISLOCATION,rows,i);
+		return rowAt(i);
+	}
+	seekRow(i);
+	if (!hasItems()) LightSpeed::throwRangeException_To(THISLOCATION,i,i);
+	return getNext();
+}
+
+natural FieldHandle::getIndex(const Result &res) const {
+	const Result::NameIndex &nx = res.getNameIndex();
+	//the same index object and the same name at cached position - index is valid
+	if (key == &nx && index < nx.names.length() && nx.names[index] == ConstStrA(name))
+		return index;
+	natural i = nx.find(name);
+	if (i == naturalNull) throw FieldNotFoundException_t(THISLOCATION,name);
+	key = &nx;
+	index = i;
+	return i;
+}
+
 void FieldNotFoundException_t::message(LightSpeed::ExceptionMsg &msg) const {
 	msg("Field '%1' has not been found in the result") << fieldName.c_str();
 }
@@ -261,7 +432,7 @@ bool Result::RangeIter::operator !=(const RangeIter& other) const {
 }
 
 Row Result::RangeIter::operator *() const {
-	return Row(owner,owner.readyRow,mysql_fetch_lengths(owner.cur->resPtr),mysql_num_fields(owner.cur->resPtr));
+	return Row(owner,owner.readyRow,owner.readyLengths,mysql_num_fields(owner.cur->resPtr),owner.readyNatives);
 }
 
 Result::RangeIter& Result::RangeIter::operator ++() {
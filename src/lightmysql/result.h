@@ -22,8 +22,15 @@
 #include "exception.h"
 #include "row.h"
 
+#if __cplusplus >= 201103L
+#include <thread>
+#include <vector>
+#include <exception>
+#endif
+
 namespace LightMySQL {
 
+class ResultSnapshot;
 
 ///Object allows to access mysql result or multiple-results
 /**
@@ -40,6 +47,37 @@ namespace LightMySQL {
  */
 class Result: public LightSpeed::SharedResource {
 
+protected:
+
+	///Lookup table of the field names
+	class NameIndex {
+	public:
+		///names of the fields
+		AutoArray<ConstStrA> names;
+		///open addressing hash table, contains index + 1, zero is empty slot
+		AutoArray<natural> slots;
+
+		///builds the table
+		void build(MYSQL_RES *res, natural count);
+		///finds field
+		/** @return index of the field, or naturalNull, if not found. If there are
+		 * more fields of the same name, the first one is returned */
+		natural find(ConstStrA name) const;
+		bool empty() const {return names.empty();}
+	};
+
+	///Index of the rows of the stored result
+	class RowIndex {
+	public:
+		///pointers to the rows
+		AutoArray<MYSQL_ROW> rows;
+		///lengths of the fields, count of fields for every row
+		AutoArray<unsigned long> lengths;
+		///index has been built
+		bool built;
+
+		RowIndex():built(false) {}
+	};
 
 	class ResultInfo: public LightSpeed::SharedResource {
 	public:
@@ -50,14 +88,24 @@ class Result: public LightSpeed::SharedResource {
 		natural fieldCount;
 		StringA error;
 		natural myerrno;
+		///index of the field names, built on the first access by the name
+		NameIndex nameIndex;
+		///index of the rows, built on the first random access
+		RowIndex rowIndex;
+		///resPtr is released with the object. It is false, when resPtr is owned by other object
+		bool ownsRes;
 
 		ResultInfo()
-		:resPtr(0),affected(0),lastId(0),warnings(0),fieldCount(0),myerrno(0) {}
+		:resPtr(0),affected(0),lastId(0),warnings(0),fieldCount(0),myerrno(0),ownsRes(true) {}
 		~ResultInfo();
 	};
 
 	typedef std::list<ResultInfo> ResultList_t;
 	friend class Connection;
+	friend class QueryBatch;
+	friend class AsyncReactor;
+	friend class ColumnarResult;
+	friend class FieldHandle;
 
 public:
 
@@ -118,7 +166,7 @@ public:
 	Row getNext();
 
 	///Moves internal pointer to the first row
-	void rewind();
+	virtual void rewind();
 
 	///Retrieves count of affected rows for current result
 	/**
@@ -189,9 +237,9 @@ public:
 	void throwErrorException(const ProgramLocation &loc) const;
 
 	///Retrieves offset to the current row in the current result
-	MYSQL_ROW_OFFSET tell() const;
+	virtual MYSQL_ROW_OFFSET tell() const;
 	///Seeks to the current result
-	void seek(MYSQL_ROW_OFFSET rc);
+	virtual void seek(MYSQL_ROW_OFFSET rc);
 
 	///returns true, there is no table result
 	/**
@@ -206,13 +254,22 @@ public:
 	///returns count of fields in the result
 	natural countFields() const;
 	///returns count of rpws in the result
-	natural countRows() const;
+	virtual natural countRows() const;
 	///returns field name under given index
 	/**
 	 * @param i zero-based index
 	 * @return field name
 	 */
 	ConstStrA getFieldName(natural i) const;
+	///returns index of the field
+	/**
+	 * Names are indexed by a hash table, which is built on the first call
+	 * for the current result. Following calls are O(1)
+	 *
+	 * @param name name of the field
+	 * @return zero-based index, or naturalNull, if the field doesn't exist
+	 */
+	natural getFieldIndex(ConstStrA name) const;
 
 	///returns MYSQL field information of field at given index
 	/**
@@ -247,20 +304,133 @@ public:
 	/** You cannot dereference the iterator, it just marks end of result */
 	RangeIter end();
 
+	///Moves the current result into an immutable snapshot
+	/**
+	 * All rows of the current result are read and stored in the snapshot
+	 * with the metadata of the fields. The snapshot can be shared by
+	 * many threads, each thread reads it through own cursor.
+	 *
+	 * @return snapshot of the current result
+	 *
+	 * @note The data of the current result are moved, so the current result
+	 * (in this object and all its copies) becomes the result without a table.
+	 * Rows of the stored result are not copied, rows of other results are
+	 * copied as text.
+	 *
+	 * @see ResultSnapshot
+	 */
+	ResultSnapshot freeze();
+
+	///Retrieves row at given index
+	/**
+	 * Rows of the stored result are indexed on the first call, following calls
+	 * are O(1) and they don't change the reading position. Rows of snapshots
+	 * are accessed directly. Other results (prepared statements) seek to
+	 * the row, reading position is moved after the row.
+	 *
+	 * @param i zero-based index of the row
+	 * @return row
+	 * @exception RangeException index is out of range
+	 */
+	Row row(natural i);
+
+#if __cplusplus >= 201103L
+	///Processes rows of the current result in parallel
+	/**
+	 * Rows are split into contiguous ranges, every range is processed by
+	 * own thread, first range is processed by the current thread. Function is
+	 * called as fn(natural range, const Row &row), rows of one range are
+	 * passed in order.
+	 *
+	 * @param rangeCount count of ranges. It is limited by count of rows
+	 * @param fn function called for every row. Calls from different ranges
+	 * run concurrently, so use per-range accumulators, or synchronize the
+	 * access to the shared state
+	 *
+	 * @note Only stored results and snapshots are processed in parallel. Other results are
+	 * processed by the current thread as a single range. If the function throws
+	 * an exception, the range is stopped and the first exception is rethrown after
+	 * all threads finish.
+	 */
+	template<typename Fn>
+	void parallelForEach(natural rangeCount, Fn fn);
+#endif
+
 
 protected:
 	///protected ctor
 	Result(MYSQL &sql, IDebugLog *logObject);
+	///constructs object containing single result
+	/** Used by derived classes, which supply the rows from other source
+	 * than MYSQL_RES. The nfo.resPtr can contain result metadata only.
+	 */
+	Result(const ResultInfo &nfo);
+
+	///constructs object from the list of results, list is emptied
+	Result(ResultList_t &list);
+
+	///reads current result of the connection
+	static ResultInfo readResultInfo(MYSQL &sql, IDebugLog *logObject);
+	///creates information about the result already stored by the client library
+	/**
+	 * @param sql connection
+	 * @param res stored result, can be NULL, if the statement has no result set
+	 * @param logObject log object
+	 * @return result info
+	 */
+	static ResultInfo makeResultInfo(MYSQL &sql, MYSQL_RES *res, IDebugLog *logObject);
 
 
 	void freeResult();
 	void initResult();
-	void loadNextRow() const;
+	///loads next row into readyRow and readyLengths
+	/** Derived classes can override the function to supply rows from
+	 * a different source. */
+	virtual void loadNextRow() const;
+	///Determines whether rows returned by loadNextRow() are valid until resPtr is released
+	/** Derived classes, which reuse buffers for every row, return false */
+	virtual bool stableRows() const {return true;}
+	///Moves reading position to the row, used by row() when rows are not stable
+	virtual void seekRow(natural i);
+	///retrieves index of the rows of the current result, builds it when needed
+	/** @note Index is available for stable rows only */
+	const RowIndex &getRowIndex() const;
+	///creates row from the index
+	Row indexedRow(const RowIndex &idx, natural i);
+	///Prepares access to the rows by the index
+	/** Called before rowAt() is called from more threads, it builds
+	 * all lazy indexes.
+	 * @return count of rows, or naturalNull, if rows cannot be accessed by the index
+	 */
+	virtual natural prepareRows();
+	///Creates row at given index, rows must be prepared by prepareRows()
+	/** Function doesn't change the reading position, it can be called from more threads */
+	virtual Row rowAt(natural i);
+	///Takes the next row with lengths and native values of its fields
+	/** Row is consumed the same way as getNext() does, data are valid until
+	 * the next row is loaded
+	 * @param row receives fields of the row
+	 * @param lengths receives lengths of the fields
+	 * @param natives receives native values of the fields, NULL if not available
+	 * @retval true row has been taken
+	 * @retval false no more rows
+	 */
+	bool takeRow(MYSQL_ROW &row, const unsigned long *&lengths, const NativeField *&natives);
+	///Creates row of this result
+	Row makeRow(MYSQL_ROW row, unsigned long *lengths, const NativeField *natives = 0) {
+		return Row(*this,row,lengths,cur->fieldCount,natives);
+	}
 
 	void checkResult(const ProgramLocation &loc) const;
+	///retrieves index of the field names of the current result, builds it when needed
+	const NameIndex &getNameIndex() const;
 
 	///row prepared to read
 	mutable MYSQL_ROW readyRow;
+	///lengths of fields of the readyRow
+	mutable unsigned long *readyLengths;
+	///native values of fields of the readyRow, NULL if not available
+	mutable const NativeField *readyNatives;
 	///offset of first row (for rewind() function)
 	MYSQL_ROW_OFFSET firstRow;
 	///list of results
@@ -270,6 +440,46 @@ protected:
 
 };
 
+#if __cplusplus >= 201103L
+
+template<typename Fn>
+void Result::parallelForEach(natural rangeCount, Fn fn) {
+	if (noTableResult()) return;
+	//indexes are built lazily, so build them before threads are started
+	natural rows = prepareRows();
+	if (rows == naturalNull) {
+		rewind();
+		while (hasItems()) fn((natural)0,getNext());
+		return;
+	}
+	if (rangeCount > rows) rangeCount = rows;
+	if (rangeCount == 0) return;
+
+	std::vector<std::exception_ptr> errors(rangeCount);
+	auto worker = [&](natural r) {
+		natural from = rows * r / rangeCount;
+		natural to = rows * (r + 1) / rangeCount;
+		try {
+			for (natural i = from; i < to; i++) fn(r,rowAt(i));
+		} catch (...) {
+			errors[r] = std::current_exception();
+		}
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(rangeCount - 1);
+	try {
+		for (natural r = 1; r < rangeCount; r++) threads.emplace_back(worker,r);
+	} catch (...) {
+		for (auto &t: threads) t.join();
+		throw;
+	}
+	worker(0);
+	for (auto &t: threads) t.join();
+	for (auto &e: errors) if (e) std::rethrow_exception(e);
+}
+
+#endif
+
 ///Exception - Abstract exception object for all exception that refers a field in the result
 class FieldException_t: public Exception_t {
 public:
@@ -0,0 +1,255 @@
+/*
+ * resultJsonWriter.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "resultJsonWriter.h"
+#include "dateTime.h"
+#include "escape.h"
+#include "jsonText.h"
+#include "numberFormat.h"
+#include <lightspeed/base/containers/autoArray.tcc>
+#include <lightspeed/base/containers/convertString.tcc>
+#include <lightspeed/utils/base64.tcc>
+#include <lightspeed/base/memory/smallAlloc.h>
+#include <lightspeed/base/streams/utf.h>
+#include <lightspeed/base/streams/utf.tcc>
+
+namespace LightMySQL {
+
+ResultJsonWriter::ResultJsonWriter(const JSON::PFactory &factory, const Result &result, bool strDate)
+	:DBResultToJSON(factory,result,strDate) {}
+
+ResultJsonWriter::ResultJsonWriter(const JSON::PFactory &factory, const Result &result, bool strDate, bool noInit, bool buildArray)
+	:DBResultToJSON(factory,result,strDate,noInit,buildArray) {}
+
+ResultJsonWriter::ResultJsonWriter(const JSON::PFactory &factory, const SnapshotResult &result, bool strDate)
+	:DBResultToJSON(factory,static_cast<const Result &>(result),strDate) {}
+
+void ResultJsonWriter::writeString(AutoArray<char> &out, ConstStrA text) {
+	static const char hex[] = "0123456789abcdef";
+	const char *p = text.data();
+	const char *e = p + text.length();
+	const char *run = p;
+	out.add('"');
+	for(;;) {
+		p += jsonFindSpecial(p,e - p);
+		if (p == e) break;
+		unsigned char c = (unsigned char)*p;
+		out.append(ConstStrA(run,p - run));
+		out.add('\\');
+		switch (c) {
+		case '"': out.add('"');break;
+		case '\\': out.add('\\');break;
+		case '\b': out.add('b');break;
+		case '\f': out.add('f');break;
+		case '\n': out.add('n');break;
+		case '\r': out.add('r');break;
+		case '\t': out.add('t');break;
+		default:
+			out.append(ConstStrA("u00"));
+			out.add(hex[c >> 4]);
+			out.add(hex[c & 0xF]);
+			break;
+		}
+		run = ++p;
+	}
+	out.append(ConstStrA(run,p - run));
+	out.add('"');
+}
+
+void ResultJsonWriter::writeInt(AutoArray<char> &out, LightSpeed::integer v) {
+	appendSigned(out,v);
+}
+
+void ResultJsonWriter::writeDouble(AutoArray<char> &out, double v) {
+	//JSON has no representation of NaN and infinity
+	if (v != v || v - v != v - v) {
+		out.append(ConstStrA("null"));
+		return;
+	}
+	appendDouble(out,v);
+}
+
+void ResultJsonWriter::writeSet(AutoArray<char> &out, ConstStrA text, char sep) {
+	out.add('[');
+	bool first = true;
+	if (!text.empty()) {
+		for (ConstStrA::SplitIterator iter = text.split(sep);iter.hasItems();) {
+			ConstStrA name = iter.getNext();
+			if (!name.empty()) {
+				if (!first) out.add(',');
+				first = false;
+				writeString(out,name);
+			}
+		}
+	}
+	out.add(']');
+}
+
+void ResultJsonWriter::writeDateTime(AutoArray<char> &out, ConstStrA text) {
+	if (strDate && !isISODateEnabled()) {
+		writeString(out,text);
+		return;
+	}
+	DBDateTime dt;
+	if (!dt.parse(text)) {
+		if (strDate) {
+			writeString(out,text);
+		} else {
+			//same value as DBResultToJSON::getRow() produces
+			String msg = InvalidDateTimeFormat(THISLOCATION,text).getMessage();
+			AutoArray<char,SmallAlloc<256> > buff;
+			WideToUtf8Reader<ConstStrW::Iterator> iter(msg.getFwIter());
+			while (iter.hasItems()) buff.add(iter.getNext());
+			writeString(out,ConstStrA(buff));
+		}
+		return;
+	}
+	if (strDate) {
+		char buff[DBDateTime::isoMaxLength];
+		writeString(out,ConstStrA(buff,dt.formatISO(buff)));
+	} else {
+		writeDouble(out,dt.toTimeStamp().getFloat());
+	}
+}
+
+void ResultJsonWriter::writeValue(const Row &row, natural index, AutoArray<char> &out) {
+	const RowItem &r = rowDesc[index];
+	FieldContent v = row[(int)index];
+	if (v.isNull()) {
+		out.append(ConstStrA("null"));
+		return;
+	}
+	switch (r.format) {
+		case integer: writeInt(out,v.as<LightSpeed::integer>());break;
+		case datetime: writeDateTime(out,v.as<ConstStrA>());break;
+		case floatnum: writeDouble(out,v.as<double>());break;
+		case set: writeSet(out,v.as<ConstStrA>(),',');break;
+		case setWithCustomSep1: writeSet(out,v.as<ConstStrA>(),customSep1);break;
+		case setWithCustomSep2: writeSet(out,v.as<ConstStrA>(),customSep2);break;
+		case binary: writeString(out,convertString(Base64Encoder(),v.as<ConstBin>()));break;
+		case jsonstr: {
+			ConstStrA txt = v.as<ConstStrA>();
+			if (txt.empty()) {
+				out.append(ConstStrA("null"));
+			} else {
+				//valid json is copied, otherwise it is stored as string
+				if (JsonText::validate(txt)) out.append(txt);
+				else writeString(out,txt);
+			}
+			break;
+		}
+		case boolean: {
+			ConstStrA s = v.as<ConstStrA>();
+			bool b = s != "false" && s != "FALSE" && s != "False" && s != "0";
+			out.append(ConstStrA(b?"true":"false"));
+			break;
+		}
+		default: writeString(out,v.as<ConstStrA>());break;
+	}
+}
+
+void ResultJsonWriter::writeObject(const Row &row, const GroupPlan &plan, natural slot, AutoArray<char> &out) {
+	out.add('{');
+	bool first = true;
+	for (natural c = plan.slots[slot].firstChild; c != naturalNull; c = plan.slots[c].next) {
+		const GroupPlan::Slot &s = plan.slots[c];
+		if (!first) out.add(',');
+		first = false;
+		out.append(ConstStrA(s.key));
+		if (s.field == naturalNull) writeObject(row,plan,c,out);
+		else writeValue(row,s.field,out);
+	}
+	out.add('}');
+}
+
+void ResultJsonWriter::writeRow(const Row &row, AutoArray<char> &out) {
+	const GroupPlan &p = getPlan();
+	if (buildArray) {
+		out.add('[');
+		for (natural i = 0; i < p.order.length(); i++) {
+			if (i) out.add(',');
+			writeValue(row,p.order[i],out);
+		}
+		out.add(']');
+	} else {
+		writeObject(row,p,0,out);
+	}
+}
+
+void ResultJsonWriter::writeHeader(AutoArray<char> &out) {
+	out.add('[');
+	for (natural i = 0; i < rowDesc.length(); i++) {
+		if (i) out.add(',');
+		writeString(out,rowDesc[i].name);
+	}
+	out.add(']');
+}
+
+void ResultJsonWriter::writeRows(Result &res, AutoArray<char> &out) {
+	out.add('[');
+	bool first = true;
+	while (res.hasItems()) {
+		if (!first) out.add(',');
+		first = false;
+		writeRow(res.getNext(),out);
+	}
+	out.add(']');
+}
+
+void ResultJsonWriter::writeRows(Result &res, IOutput &out, natural flushSize) {
+	AutoArray<char> buff;
+	buff.add('[');
+	bool first = true;
+	while (res.hasItems()) {
+		if (!first) buff.add(',');
+		first = false;
+		writeRow(res.getNext(),buff);
+		if (buff.length() >= flushSize) {
+			out.write(ConstStrA(buff.data(),buff.length()));
+			buff.clear();
+		}
+	}
+	buff.add(']');
+	out.write(ConstStrA(buff.data(),buff.length()));
+}
+
+#if __cplusplus >= 201103L
+
+void ResultJsonWriter::writeRowsParallel(Result &res, IOutput &out, natural rangeCount) {
+	writeParallel(res,out,rangeCount);
+}
+
+void ResultJsonWriter::writeRowsParallel(SnapshotResult &res, IOutput &out, natural rangeCount) {
+	writeParallel(res,out,rangeCount);
+}
+
+template<typename R>
+void ResultJsonWriter::writeParallel(R &res, IOutput &out, natural rangeCount) {
+	if (rangeCount == 0) rangeCount = 1;
+	//plan must be ready before threads are started
+	getPlan();
+	std::vector<AutoArray<char> > buffers(rangeCount);
+	res.parallelForEach(rangeCount,[&](natural range, const Row &row) {
+		AutoArray<char> &buff = buffers[range];
+		if (!buff.empty()) buff.add(',');
+		writeRow(row,buff);
+	});
+	out.write(ConstStrA("["));
+	bool first = true;
+	for (natural i = 0; i < buffers.size(); i++) {
+		const AutoArray<char> &buff = buffers[i];
+		if (buff.empty()) continue;
+		if (!first) out.write(ConstStrA(","));
+		first = false;
+		out.write(ConstStrA(buff.data(),buff.length()));
+	}
+	out.write(ConstStrA("]"));
+}
+
+#endif
+
+}
@@ -0,0 +1,118 @@
+/*
+ * resultJsonWriter.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_RESULTJSONWRITER_H_
+#define LIGHTMYSQL_RESULTJSONWRITER_H_
+
+#include "json.h"
+#include "resultSnapshot.h"
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+///Writes rows of the result directly as JSON text
+/**
+ * Writer uses the same configuration as the DBResultToJSON (formats,
+ * renaming, groups, ISO dates), but it doesn't build JSON nodes. Every row
+ * is written as text into the buffer, so the memory doesn't depend on
+ * count of rows, when the buffer is flushed to the output.
+ *
+ * Fields in the jsonstr format are validated by JsonText::validate() and
+ * copied verbatim, invalid text is written as string.
+ *
+ * @code
+ * ResultJsonWriter wr(factory,res,true);
+ * wr.setGroupSeparator('.');
+ * wr.writeRows(res,output);
+ * @endcode
+ *
+ * Layout of the object is taken from the compiled plan of the DBResultToJSON.
+ */
+class ResultJsonWriter: public DBResultToJSON {
+public:
+
+	///Receives JSON text
+	class IOutput {
+	public:
+		///Writes the text
+		virtual void write(ConstStrA text) = 0;
+		virtual ~IOutput() {}
+	};
+
+	ResultJsonWriter(const JSON::PFactory &factory, const Result &result, bool strDate);
+	ResultJsonWriter(const JSON::PFactory &factory, const Result &result, bool strDate, bool noInit, bool buildArray);
+	///Creates writer for the rows of the snapshot
+	/** @param result cursor of the snapshot, it must be valid while the writer is used */
+	ResultJsonWriter(const JSON::PFactory &factory, const SnapshotResult &result, bool strDate);
+
+	///Appends row to the buffer
+	/**
+	 * @param row row to write
+	 * @param out buffer. Row is appended as the object or array (buildArray)
+	 */
+	void writeRow(const Row &row, AutoArray<char> &out);
+	///Appends header to the buffer (array of names of the fields)
+	void writeHeader(AutoArray<char> &out);
+	///Writes all remaining rows of the result as JSON array
+	/**
+	 * @param res result, rows are read by getNext()
+	 * @param out buffer
+	 */
+	void writeRows(Result &res, AutoArray<char> &out);
+	///Writes all remaining rows of the result as JSON array
+	/**
+	 * @param res result, rows are read by getNext()
+	 * @param out output
+	 * @param flushSize size of the buffer, when the buffer is flushed to the output
+	 */
+	void writeRows(Result &res, IOutput &out, natural flushSize = 65536);
+
+#if __cplusplus >= 201103L
+	///Writes all rows of the stored result as JSON array using more threads
+	/**
+	 * Rows are split into contiguous ranges (see Result::parallelForEach()),
+	 * every range is converted by own thread into own buffer. Buffers are
+	 * passed to the output in the order of the rows, they are not joined
+	 * into single buffer.
+	 *
+	 * @param res stored result. Other results are converted by the current thread
+	 * @param out output
+	 * @param rangeCount count of ranges (threads)
+	 *
+	 * @note Whole output is kept in the memory until it is written.
+	 */
+	void writeRowsParallel(Result &res, IOutput &out, natural rangeCount);
+	///Writes all rows of the snapshot as JSON array using more threads
+	/**
+	 * @param res cursor of the snapshot
+	 * @param out output
+	 * @param rangeCount count of ranges (threads)
+	 */
+	void writeRowsParallel(SnapshotResult &res, IOutput &out, natural rangeCount);
+#endif
+
+	///Appends string as JSON string including quotes
+	static void writeString(AutoArray<char> &out, ConstStrA text);
+
+protected:
+
+	void writeObject(const Row &row, const GroupPlan &plan, natural slot, AutoArray<char> &out);
+	void writeValue(const Row &row, natural index, AutoArray<char> &out);
+	void writeSet(AutoArray<char> &out, ConstStrA text, char sep);
+	void writeDateTime(AutoArray<char> &out, ConstStrA text);
+	static void writeInt(AutoArray<char> &out, LightSpeed::integer v);
+	static void writeDouble(AutoArray<char> &out, double v);
+#if __cplusplus >= 201103L
+	template<typename R>
+	void writeParallel(R &res, IOutput &out, natural rangeCount);
+#endif
+};
+
+}
+
+#endif /* LIGHTMYSQL_RESULTJSONWRITER_H_ */
@@ -0,0 +1,191 @@
+/*
+ * resultSnapshot.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "resultSnapshot.h"
+#include <lightspeed/base/containers/autoArray.tcc>
+#include <lightspeed/base/exceptions/throws.tcc>
+
+namespace LightMySQL {
+
+ResultSnapshot::Data::~Data() {
+	if (meta) mysql_free_result(meta);
+}
+
+ResultSnapshot Result::freeze() {
+	checkResult(THISLOCATION);
+	RefCntPtr<ResultSnapshot::Data> d = new ResultSnapshot::Data;
+	d->affected = cur->affected;
+	d->lastId = cur->lastId;
+	d->warnings = cur->warnings;
+	if (cur->resPtr) {
+		natural cnt = mysql_num_fields(cur->resPtr);
+		bool stable = stableRows();
+		//offsets to the arena, naturalNull for NULL
+		AutoArray<natural> offsets;
+		d->fields = cnt;
+		rewind();
+		MYSQL_ROW values;
+		const unsigned long *lengths;
+		const NativeField *natives;
+		while (takeRow(values,lengths,natives)) {
+			for (natural i = 0; i < cnt; i++) {
+				char *v = values[i];
+				if (stable) {
+					d->values.add(v);
+					d->lengths.add(v?lengths[i]:0);
+				} else if (v == 0) {
+					offsets.add(naturalNull);
+					d->lengths.add(0);
+				} else {
+					const NativeField *n = natives && natives[i].type != NativeField::typeText?natives + i:0;
+					ConstStrA txt = n?n->getText():ConstStrA(v,lengths[i]);
+					offsets.add(d->arena.length());
+					d->arena.append(txt);
+					d->arena.add(0);
+					d->lengths.add(txt.length());
+				}
+			}
+			d->rows++;
+		}
+		if (!stable) {
+			//arena doesn't grow anymore, pointers can be calculated
+			char *base = const_cast<char *>(d->arena.data());
+			for (natural i = 0; i < offsets.length(); i++)
+				d->values.add(offsets[i] == naturalNull?0:base + offsets[i]);
+		}
+		//metadata and stored rows now belong to the snapshot
+		d->meta = cur->resPtr;
+		cur->resPtr = 0;
+		initResult();
+	}
+	//snapshot is shared between threads, so counter must be atomic
+	return ResultSnapshot(d.getMT());
+}
+
+ResultSnapshot::ResultSnapshot():data(RefCntPtr<Data>(new Data).getMT()) {}
+
+ResultSnapshot::ResultSnapshot(const RefCntPtr<Data> &data):data(data) {}
+
+natural ResultSnapshot::countRows() const {
+	return data->rows;
+}
+
+natural ResultSnapshot::countFields() const {
+	return data->fields;
+}
+
+ConstStrA ResultSnapshot::getFieldName(natural col) const {
+	if (col >= data->fields)
+		throwRangeException_To(THISLOCATION,data->fields,col);
+	const MYSQL_FIELD *f = mysql_fetch_field_direct(data->meta,col);
+	return ConstStrA(f->name,f->name_length);
+}
+
+natural ResultSnapshot::getFieldIndex(ConstStrA name) const {
+	for (natural i = 0; i < data->fields; i++)
+		if (getFieldName(i) == name) return i;
+	return naturalNull;
+}
+
+void ResultSnapshot::checkCell(natural row, natural col) const {
+	if (row >= data->rows)
+		throwRangeException_To(THISLOCATION,data->rows,row);
+	if (col >= data->fields)
+		throwRangeException_To(THISLOCATION,data->fields,col);
+}
+
+bool ResultSnapshot::isNull(natural row, natural col) const {
+	checkCell(row,col);
+	return data->values[row * data->fields + col] == 0;
+}
+
+ConstStrA ResultSnapshot::get(natural row, natural col) const {
+	checkCell(row,col);
+	natural ofs = row * data->fields + col;
+	const char *v = data->values[ofs];
+	if (v == 0) return ConstStrA();
+	return ConstStrA(v,data->lengths[ofs]);
+}
+
+SnapshotResult ResultSnapshot::read() const {
+	return SnapshotResult(*this);
+}
+
+
+SnapshotResult::SnapshotResult(const ResultSnapshot &snapshot)
+	:Result(makeInfo(*snapshot.data)),snapshot(snapshot),pos(0) {}
+
+Result::ResultInfo SnapshotResult::makeInfo(const ResultSnapshot::Data &data) {
+	ResultInfo nfo;
+	nfo.resPtr = data.meta;
+	nfo.ownsRes = false;
+	nfo.fieldCount = data.fields;
+	nfo.affected = data.affected;
+	nfo.lastId = data.lastId;
+	nfo.warnings = data.warnings;
+	return nfo;
+}
+
+void SnapshotResult::loadNextRow() const {
+	checkResult(THISLOCATION);
+	const ResultSnapshot::Data &d = *snapshot.data;
+	if (pos < d.rows) {
+		natural ofs = pos * d.fields;
+		//Row doesn't modify the values
+		readyRow = const_cast<char **>(d.values.data()) + ofs;
+		readyLengths = const_cast<unsigned long *>(d.lengths.data()) + ofs;
+		pos++;
+	} else {
+		readyRow = 0;
+	}
+}
+
+natural SnapshotResult::prepareRows() {
+	checkResult(THISLOCATION);
+	getNameIndex();
+	return snapshot.data->rows;
+}
+
+Result::Row SnapshotResult::rowAt(natural i) {
+	const ResultSnapshot::Data &d = *snapshot.data;
+	natural ofs = i * d.fields;
+	//Row doesn't modify the values
+	return makeRow(const_cast<char **>(d.values.data()) + ofs,
+			const_cast<unsigned long *>(d.lengths.data()) + ofs);
+}
+
+void SnapshotResult::setPosition(natural row) {
+	if (row > snapshot.data->rows)
+		throwRangeException_To(THISLOCATION,snapshot.data->rows + 1,row);
+	pos = row;
+	readyRow = 0;
+}
+
+natural SnapshotResult::getPosition() const {
+	//prepared row has been already counted
+	return readyRow?pos - 1:pos;
+}
+
+void SnapshotResult::rewind() {
+	setPosition(0);
+}
+
+MYSQL_ROW_OFFSET SnapshotResult::tell() const {
+	//zero is not valid offset, so index is shifted by one
+	return reinterpret_cast<MYSQL_ROW_OFFSET>(getPosition() + 1);
+}
+
+void SnapshotResult::seek(MYSQL_ROW_OFFSET rc) {
+	if (rc != 0) setPosition(reinterpret_cast<natural>(rc) - 1);
+}
+
+natural SnapshotResult::countRows() const {
+	if (noTableResult()) return 0;
+	return snapshot.data->rows;
+}
+
+}
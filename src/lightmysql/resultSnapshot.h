@@ -0,0 +1,187 @@
+/*
+ * resultSnapshot.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_RESULTSNAPSHOT_H_
+#define LIGHTMYSQL_RESULTSNAPSHOT_H_
+
+#include <lightspeed/base/containers/autoArray.h>
+#include <lightspeed/base/memory/refCntPtr.h>
+#include "result.h"
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+class SnapshotResult;
+
+///Immutable snapshot of the result, which can be shared between threads
+/**
+ * Snapshot is created by Result::freeze(). It contains all rows of the
+ * result set and the metadata of the fields. Snapshot cannot be changed,
+ * it is reference counted atomically, so copies of the object can be passed
+ * to other threads and read concurrently.
+ *
+ * Every thread reads the snapshot through own cursor (see read()), or
+ * it can access the values directly by the index of the row.
+ *
+ * @code
+ * ResultSnapshot snap = q("SELECT * FROM countries").exec().freeze();
+ * //any thread
+ * SnapshotResult res = snap.read();
+ * while (res.hasItems()) {
+ *     Row rw = res.getNext();
+ *     ...
+ * }
+ * @endcode
+ */
+class ResultSnapshot {
+public:
+
+	///Creates empty snapshot
+	ResultSnapshot();
+
+	///Retrieves count of rows
+	natural countRows() const;
+	///Retrieves count of fields
+	natural countFields() const;
+	///Retrieves name of the field
+	ConstStrA getFieldName(natural col) const;
+	///Retrieves index of the field
+	/** @return index of the field, or naturalNull, if not found */
+	natural getFieldIndex(ConstStrA name) const;
+	///Tests, whether value is NULL
+	/**
+	 * @param row index of the row
+	 * @param col index of the field
+	 */
+	bool isNull(natural row, natural col) const;
+	///Retrieves value as text
+	/**
+	 * @param row index of the row
+	 * @param col index of the field
+	 * @return text of the value, empty for NULL
+	 */
+	ConstStrA get(natural row, natural col) const;
+
+	///Creates cursor for the current thread
+	/**
+	 * @return result object, which reads rows of the snapshot. The object
+	 * must not be shared between threads, create one for every thread
+	 */
+	SnapshotResult read() const;
+
+protected:
+
+	class Data: public RefCntObj {
+	public:
+		///metadata of the fields (owned)
+		MYSQL_RES *meta;
+		natural fields;
+		natural rows;
+		my_ulonglong affected;
+		my_ulonglong lastId;
+		natural warnings;
+		///values copied from the result, when rows of the result are not stable
+		AutoArray<char> arena;
+		///pointers to values, fields * rows items
+		AutoArray<char *> values;
+		///lengths of values, fields * rows items
+		AutoArray<unsigned long> lengths;
+
+		Data():meta(0),fields(0),rows(0),affected(0),lastId(0),warnings(0) {}
+		~Data();
+	};
+
+	RefCntPtr<Data> data;
+
+	ResultSnapshot(const RefCntPtr<Data> &data);
+
+	void checkCell(natural row, natural col) const;
+
+	friend class Result;
+	friend class SnapshotResult;
+};
+
+///Cursor of the ResultSnapshot
+/**
+ * Object works as the Result. Rows can be read sequentially,
+ * or any row can be selected by setPosition() in O(1). Function
+ * parallelForEach() processes rows by more threads.
+ *
+ * Object cannot be converted to the Result. The Result would read rows from
+ * the metadata of the snapshot, which are shared by all threads.
+ */
+class SnapshotResult: protected Result {
+public:
+
+	using Result::Row;
+	using Result::RangeIter;
+	using Result::hasResult;
+	using Result::nextResult;
+	using Result::firstResult;
+	using Result::hasItems;
+	using Result::getNext;
+	using Result::getAffectedRows;
+	using Result::getInsertId;
+	using Result::getWarningCount;
+	using Result::getFieldCount;
+	using Result::getError;
+	using Result::getErrNo;
+	using Result::isError;
+	using Result::throwErrorException;
+	using Result::noTableResult;
+	using Result::empty;
+	using Result::countFields;
+	using Result::getFieldName;
+	using Result::getFieldIndex;
+	using Result::getFieldInfo;
+	using Result::begin;
+	using Result::end;
+	using Result::row;
+#if __cplusplus >= 201103L
+	using Result::parallelForEach;
+#endif
+
+	///Moves cursor to the row
+	/**
+	 * @param row index of the row, next getNext() returns this row
+	 */
+	void setPosition(natural row);
+	///Retrieves index of the row, which will be returned by next getNext()
+	natural getPosition() const;
+	///Returns the snapshot, rows are already frozen
+	ResultSnapshot freeze() const {return snapshot;}
+
+	virtual void rewind();
+	virtual MYSQL_ROW_OFFSET tell() const;
+	virtual void seek(MYSQL_ROW_OFFSET rc);
+	virtual natural countRows() const;
+
+protected:
+	SnapshotResult(const ResultSnapshot &snapshot);
+
+	///metadata are owned by the snapshot
+	static ResultInfo makeInfo(const ResultSnapshot::Data &data);
+	virtual void loadNextRow() const;
+	///rows are served from the snapshot, not from the metadata result
+	virtual bool stableRows() const {return false;}
+	virtual void seekRow(natural i) {setPosition(i);}
+	///rows are stored in the snapshot, they can be accessed by the index
+	virtual natural prepareRows();
+	virtual Row rowAt(natural i);
+
+	ResultSnapshot snapshot;
+	mutable natural pos;
+
+	friend class ResultSnapshot;
+	///writer reads the metadata only
+	friend class ResultJsonWriter;
+};
+
+}
+
+#endif /* LIGHTMYSQL_RESULTSNAPSHOT_H_ */
@@ -14,9 +14,14 @@
 
 #include "row.h"
 #include "result.h"
+#include "dateTime.h"
+#include "numberParse.h"
 #include <lightspeed/base/exceptions/throws.tcc>
 #include <lightspeed/base/exceptions/invalidNumberFormat.h>
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <lightspeed/base/containers/autoArray.tcc>
 //#include <lightspeed/base/streams/text.tcc>
 
 namespace LightMySQL {
@@ -30,124 +35,197 @@ FieldContent Row::operator [](int index) const {
 	if (index < 0 || index >= (int)count)
 		throwRangeException_FromTo(THISLOCATION,0,(int)count-1,index);
 
-	return FieldContent(row[index],lengths[index],index,*this);
+	const NativeField *n = natives && row[index] && natives[index].type != NativeField::typeText
+			?natives + index:0;
+	return FieldContent(row[index],lengths[index],index,*this,n);
 
 }
 
 FieldContent Row::operator [](ConstStrA fieldName) const {
-	for (natural i = 0; i < count; ++i) {
-		const MYSQL_FIELD *info = owner.getFieldInfo(i);
-		if (fieldName == ConstStrA(info->name,info->name_length)) return operator[](i);
+	natural i = owner.getFieldIndex(fieldName);
+	if (i == naturalNull) throw FieldNotFoundException_t(THISLOCATION,fieldName);
+	return operator[]((int)i);
+}
+
+FieldContent Row::operator [](const FieldHandle &field) const {
+	return operator[]((int)field.getIndex(owner));
+}
+
+///Loads integer from the native value
+/** @retval true loaded
+ *  @retval false field is not native integer, text must be parsed */
+template<typename T>
+static inline bool loadNativeInt(const NativeField *n, T &out) {
+	if (n == 0) return false;
+	switch (n->type) {
+	case NativeField::typeInt: out = (T)n->value.i;return true;
+	case NativeField::typeUInt: out = (T)n->value.u;return true;
+	default: return false;
+	}
+}
+
+///Loads floating point number from the native value
+template<typename T>
+static inline bool loadNativeFloat(const NativeField *n, T &out) {
+	if (n == 0) return false;
+	switch (n->type) {
+	case NativeField::typeInt: out = (T)n->value.i;return true;
+	case NativeField::typeUInt: out = (T)n->value.u;return true;
+	case NativeField::typeFloat: out = (T)n->value.f;return true;
+	case NativeField::typeDouble: out = (T)n->value.d;return true;
+	default: return false;
 	}
-	throw FieldNotFoundException_t(THISLOCATION,fieldName);
+}
+
+void throwInvalidNumber(ConstStrA txt) {
+	throw InvalidNumberFormatException(THISLOCATION,String(txt));
 }
 
 bool FieldTypeConv<bool>::convert(const FieldContent& f)
 {
-	char *endp;
-	unsigned int r = (unsigned int)strtoul(f.value,&endp,10);
-	if (*endp) throw InvalidNumberFormatException(THISLOCATION,String(f.value));
-	return r != 0;
+	unsigned long long n;
+	if (loadNativeInt(f.getNative(),n)) return n != 0;
+	return (unsigned int)parseIntField<unsigned long long>(f.getText()) != 0;
 }
 unsigned int FieldTypeConv<unsigned int>::convert(const FieldContent& f)
 {
-	char *endp;
-	unsigned int r = (unsigned int)strtoul(f.value,&endp,10);
-	if (*endp) throw InvalidNumberFormatException(THISLOCATION,String(f.value));
-	return r;
+	unsigned int r;
+	if (loadNativeInt(f.getNative(),r)) return r;
+	return (unsigned int)parseIntField<unsigned long long>(f.getText());
 }
 
 signed int FieldTypeConv<signed int>::convert(const FieldContent& f)
 {
-	char *endp;
-	signed int r = (signed int)strtol(f.value,&endp,10);
-	if (*endp) throw InvalidNumberFormatException(THISLOCATION,String(f.value));
-	return r;
+	signed int r;
+	if (loadNativeInt(f.getNative(),r)) return r;
+	return (signed int)parseIntField<signed long long>(f.getText());
 }
 
 unsigned long FieldTypeConv<unsigned long int>::convert(const FieldContent& f)
 {
-	char *endp;
-	unsigned long r = strtol(f.value,&endp,10);
-	if (*endp) throw InvalidNumberFormatException(THISLOCATION,String(f.value));
-	return r;
+	unsigned long r;
+	if (loadNativeInt(f.getNative(),r)) return r;
+	return (unsigned long)parseIntField<unsigned long long>(f.getText());
 }
 
 signed long FieldTypeConv<signed long int>::convert(const FieldContent& f)
 {
-	char *endp;
-	signed  long r = strtol(f.value,&endp,10);
-	if (*endp) throw InvalidNumberFormatException(THISLOCATION,String(f.value));
-	return r;
+	signed long r;
+	if (loadNativeInt(f.getNative(),r)) return r;
+	return (signed long)parseIntField<signed long long>(f.getText());
 }
 
 unsigned long long FieldTypeConv<unsigned long long int>::convert(const FieldContent& f)
 {
-	char *endp;
-	unsigned long long r = strtoull(f.value,&endp,10);
-	if (*endp) throw InvalidNumberFormatException(THISLOCATION,String(f.value));
-	return r;
+	unsigned long long r;
+	if (loadNativeInt(f.getNative(),r)) return r;
+	return parseIntField<unsigned long long>(f.getText());
 }
 
 signed long long FieldTypeConv<signed long long int>::convert(const FieldContent& f)
 {
-	char *endp;
-	signed long long r = strtoll(f.value,&endp,10);
-	if (*endp) throw InvalidNumberFormatException(THISLOCATION,String(f.value));
-	return r;
+	signed long long r;
+	if (loadNativeInt(f.getNative(),r)) return r;
+	return parseIntField<signed long long>(f.getText());
 }
 
 const char* FieldTypeConv<const char *>::convert(const FieldContent& f)
 {
-	return f.value;
+	return f.getText().data();
 }
 
 ConstStrA FieldTypeConv<ConstStrA>::convert(const FieldContent& f)
 {
-	return ConstStrA(f.value,f.length);
+	return f.getText();
 }
 ConstBin FieldTypeConv<ConstBin>::convert(const FieldContent& f)
 {
-	return ConstBin(f.value,f.length);
+	ConstStrA txt = f.getText();
+	return ConstBin(txt.data(),txt.length());
 }
 
 StringA FieldTypeConv<StringA>::convert(const FieldContent& f)
 {
-	return StringA(ConstStrA(f.value,f.length));
+	return StringA(f.getText());
 }
 
 StringB FieldTypeConv<StringB>::convert(const FieldContent& f)
 {
-	return StringB(ConstBin(f.value,f.length));
+	return StringB(FieldTypeConv<ConstBin>::convert(f));
 }
 
 String FieldTypeConv<String>::convert(const FieldContent& f)
 {
-	return String(ConstStrA(f.value,f.length));
+	return String(f.getText());
 }
 
 float FieldTypeConv<float>::convert(const FieldContent& f)
 {
-	char *endp;
-	float r = strtof(f.value,&endp);
-	if (*endp) throw InvalidNumberFormatException(THISLOCATION,String(f.value));
-	return r;
+	float r;
+	if (loadNativeFloat(f.getNative(),r)) return r;
+	return parseFloatField<float>(f.getText());
 }
 
 double FieldTypeConv<double>::convert(const FieldContent& f)
 {
-	char *endp;
-	double r = strtod(f.value,&endp);
-	if (*endp) throw InvalidNumberFormatException(THISLOCATION,String(f.value));
-	return r;
+	double r;
+	if (loadNativeFloat(f.getNative(),r)) return r;
+	return parseFloatField<double>(f.getText());
 }
 
 TimeStamp FieldTypeConv<TimeStamp>::convert(const FieldContent& f)
 {
-	ConstStrA txt (f.value,f.length);
+	const NativeField *n = f.getNative();
+	if (n && n->type == NativeField::typeDateTime) {
+		const MYSQL_TIME &t = n->time;
+		return TimeStamp::fromYMDhms(t.year,t.month,t.day,t.hour,t.minute,t.second);
+	}
+	DBDateTime dt;
+	ConstStrA txt = f.getText();
+	if (dt.parse(txt)) return dt.toTimeStamp();
+	//unusual format, let the TimeStamp to handle it
 	return TimeStamp::fromDBDate(txt);
 }
 
+///formats floating point number using shortest form, which can be parsed back
+template<typename T>
+static int formatShortest(char *buff, std::size_t size, T val, int minPrec, int maxPrec) {
+	int len = 0;
+	for (int prec = minPrec; prec <= maxPrec; prec++) {
+		len = snprintf(buff,size,"%.*g",prec,(double)val);
+		if ((T)strtod(buff,0) == val) break;
+	}
+	return len;
+}
+
+ConstStrA NativeField::getText() const {
+	if (textReady) return ConstStrA(text.data(),text.length() - 1);
+	char buff[64];
+	int len;
+	switch (type) {
+	case typeInt: len = snprintf(buff,sizeof(buff),"%lld",value.i);break;
+	case typeUInt: len = snprintf(buff,sizeof(buff),"%llu",value.u);break;
+	case typeFloat: len = formatShortest(buff,sizeof(buff),value.f,6,9);break;
+	case typeDouble: len = formatShortest(buff,sizeof(buff),value.d,15,17);break;
+	case typeDateTime:
+		if (time.time_type == MYSQL_TIMESTAMP_DATE) {
+			len = snprintf(buff,sizeof(buff),"%04u-%02u-%02u",time.year,time.month,time.day);
+		} else {
+			len = snprintf(buff,sizeof(buff),"%04u-%02u-%02u %02u:%02u:%02u",
+					time.year,time.month,time.day,time.hour,time.minute,time.second);
+			if (time.second_part)
+				len += snprintf(buff+len,sizeof(buff)-len,".%06lu",(unsigned long)time.second_part);
+		}
+		break;
+	default: len = 0;break;
+	}
+	text.clear();
+	text.append(ConstStrA(buff,len));
+	text.add(0);
+	textReady = true;
+	return ConstStrA(text.data(),len);
+}
+
 
 
 }
@@ -15,6 +15,54 @@ struct FieldTypeConv;
 
 class Row;
 
+namespace _rowReader {
+	struct RowAccess;
+}
+
+///Field value fetched in the binary form
+/** Results of prepared statements can fetch numbers and dates in the
+ * native form, so they don't need to be parsed. Text form of the value is
+ * created on request.
+ */
+class NativeField {
+public:
+	enum Type {
+		///value is not native, it is available as text only
+		typeText,
+		///signed integer - value.i
+		typeInt,
+		///unsigned integer - value.u
+		typeUInt,
+		///float - value.f
+		typeFloat,
+		///double - value.d
+		typeDouble,
+		///date or date and time - time
+		typeDateTime
+	};
+
+	Type type;
+	union {
+		long long i;
+		unsigned long long u;
+		float f;
+		double d;
+	} value;
+	MYSQL_TIME time;
+
+	NativeField():type(typeText),textReady(false) {}
+
+	///Retrieves text form of the value
+	/** @return text, it is always terminated by zero */
+	ConstStrA getText() const;
+	///Invalidates text form, called when new value is fetched
+	void invalidate() {textReady = false;}
+
+protected:
+	mutable AutoArray<char> text;
+	mutable bool textReady;
+};
+
 ///General object holding content of field
 /** content is referenced as pointer to the memory and length
  * Copying this object causes that only reference will be copied.
@@ -23,7 +71,8 @@ class Row;
  */
 class FieldContent {
 	///Pointer to begin of content.
-	/** In most of case, content is stored as string with terminating zero */
+	/** In most of case, content is stored as string with terminating zero.
+	 * Native fields point to their text form, the binary value is in the native */
 	const char *value;
 	///Length of contnet in characters, not including terminating zero
 	unsigned long length;
@@ -31,6 +80,8 @@ class FieldContent {
 	natural pos;
 
 	const Row &owner;
+	///native value, NULL if field is available as text only
+	const NativeField *native;
 
 	template<typename T>
 	friend struct FieldTypeConv;
@@ -41,9 +92,17 @@ public:
 	/**
 	 * @param value pointer to content
 	 * @param length length of content in bytes
+	 * @param native native value of the field, if available
 	 */
-	FieldContent(const char *value,unsigned long length, natural pos, const Row &owner)
-		:value(value),length(length),pos(pos),owner(owner) {}
+	FieldContent(const char *value,unsigned long length, natural pos, const Row &owner,
+			const NativeField *native = 0)
+		:value(value),length(length),pos(pos),owner(owner),native(native) {
+		if (native) {
+			ConstStrA txt = native->getText();
+			this->value = txt.data();
+			this->length = (unsigned long)txt.length();
+		}
+	}
 
 	///Tests, whether object is NULL
 	/**
@@ -66,6 +125,55 @@ public:
 	natural getPos() const {return pos;}
 
 	bool empty() const {return length == 0;}
+
+	///Retrieves native value of the field
+	/** @return pointer to native value, or NULL, if the field is available as text only */
+	const NativeField *getNative() const {return native;}
+
+	///Retrieves text form of the field (terminated by zero)
+	/**
+	 * Native values are formatted to the text. This is recommended way
+	 * to read the text in the FieldTypeConv specializations.
+	 */
+	ConstStrA getText() const {return ConstStrA(value,length);}
+};
+
+///Field referred by the name, which is resolved once per result
+/**
+ * Reading a field by the name needs to find the name in the result. The
+ * handle remembers the found index, so following rows are read without
+ * the lookup.
+ *
+ * @code
+ * FieldHandle price("price");
+ * while (res.hasItems()) {
+ *     Row rw = res.getNext();
+ *     double p = rw[price];
+ * }
+ * @endcode
+ *
+ * Handle can be used with different results, the index is resolved again
+ * when the result changes.
+ */
+class FieldHandle {
+public:
+	FieldHandle(ConstStrA name):name(name),key(0),index(0) {}
+
+	///Retrieves name of the field
+	ConstStrA getName() const {return name;}
+	///Retrieves index of the field in the current result
+	/**
+	 * @param res result
+	 * @return index of the field
+	 * @exception FieldNotFoundException_t field doesn't exist
+	 */
+	natural getIndex(const Result &res) const;
+
+protected:
+	StringA name;
+	///identifies the index of names, where the field has been resolved
+	mutable const void *key;
+	mutable natural index;
 };
 
 ///Object that provides access to fields in the row.
@@ -103,6 +211,12 @@ public:
 	 *  use cast operator to retrieve value of the field
 	 */
 	FieldContent operator[](ConstStrA fieldName) const;
+	///Seeks to field referred by handle
+	/**
+	 * @param field handle of the field. Name is resolved on the first
+	 *  access, following rows are accessed directly
+	 */
+	FieldContent operator[](const FieldHandle &field) const;
 
 	///Retrieves count of fields in the result
 	/**
@@ -128,13 +242,17 @@ protected:
 	unsigned long *lengths;
 	///count of fields
 	natural count;
+	///native values of fields, NULL if all fields are text
+	const NativeField *natives;
 
 	///Constructor - cannot be called directly
-	Row(Result &owner, MYSQL_ROW row, unsigned long *lengths,unsigned int count)
-		:owner(owner),row(row),lengths(lengths),count(count) {}
+	Row(Result &owner, MYSQL_ROW row, unsigned long *lengths,unsigned int count,
+			const NativeField *natives = 0)
+		:owner(owner),row(row),lengths(lengths),count(count),natives(natives) {}
 
 	friend class Result;
 	friend class FieldContent;
+	friend struct _rowReader::RowAccess;
 private:
 	void operator=(const Result &other);
 };
@@ -0,0 +1,198 @@
+/*
+ * rowReader.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_ROWREADER_H_
+#define LIGHTMYSQL_ROWREADER_H_
+
+#include "result.h"
+
+//variadic templates need C++11
+#if __cplusplus >= 201103L
+
+#include <tuple>
+#include <initializer_list>
+
+namespace LightMySQL {
+
+namespace _rowReader {
+
+	template<natural... I> struct IndexSeq {};
+	template<natural N, natural... I> struct MakeIndexSeq: MakeIndexSeq<N-1, N-1, I...> {};
+	template<natural... I> struct MakeIndexSeq<0, I...> {typedef IndexSeq<I...> Type;};
+
+	///resolves names of the fields to indexes
+	/** @return count of fields needed in the row (highest index + 1) */
+	inline natural resolveFields(const Result &res, const ConstStrA *names, natural count, natural *idx) {
+		natural need = 0;
+		for (natural i = 0; i < count; i++) {
+			idx[i] = res.getFieldIndex(names[i]);
+			if (idx[i] == naturalNull) throw FieldNotFoundException_t(THISLOCATION,names[i]);
+			if (idx[i] >= need) need = idx[i] + 1;
+		}
+		return need;
+	}
+
+	///Decodes fields directly from the row
+	struct RowAccess {
+		///checks, whether row has the fields used by the reader
+		static void checkRow(const Row &rw, natural need) {
+			if (rw.count < need) throwRangeException_To(THISLOCATION,rw.count,need - 1);
+		}
+		///converts the field, index must be checked by checkRow()
+		template<typename T>
+		static T get(const Row &rw, natural i) {
+			const char *v = rw.row[i];
+			const NativeField *n = rw.natives && v && rw.natives[i].type != NativeField::typeText
+					?rw.natives + i:0;
+			return FieldContent(v,rw.lengths[i],i,rw,n).template as<T>();
+		}
+	};
+}
+
+///Reads rows of the result as tuples
+/**
+ * Columns are resolved once when the reader is created. Every value is
+ * converted by the FieldTypeConv of the type of the tuple element, so
+ * unsupported types are reported by the compiler.
+ *
+ * @code
+ * TupleReader<long long, ConstStrA, TimeStamp> rd(res, {"id","name","created"});
+ * while (rd.hasItems()) {
+ *     std::tuple<long long, ConstStrA, TimeStamp> t = rd.getNext();
+ *     ...
+ * }
+ * @endcode
+ *
+ * @note Reader maps the current result. Create new reader after nextResult().
+ * NULL value throws NullFieldException_t the same way as FieldContent::as().
+ */
+template<typename... T>
+class TupleReader {
+public:
+	typedef std::tuple<T...> Tuple;
+	static const natural count = sizeof...(T);
+	static_assert(sizeof...(T) > 0, "TupleReader needs at least one type");
+
+	///Maps columns by position, first column to the first element
+	TupleReader(Result &res):res(res),need(count) {
+		for (natural i = 0; i < count; i++) idx[i] = i;
+	}
+	///Maps columns by names
+	/**
+	 * @param res result
+	 * @param names names of the columns for every element of the tuple
+	 * @exception FieldNotFoundException_t column doesn't exist
+	 * @exception RangeException count of names doesn't match count of elements
+	 */
+	TupleReader(Result &res, std::initializer_list<ConstStrA> names):res(res) {
+		if (names.size() != count) throwRangeException_FromTo(THISLOCATION,count,count,names.size());
+		need = _rowReader::resolveFields(res,names.begin(),count,idx);
+	}
+
+	bool hasItems() const {return res.hasItems();}
+	Tuple getNext() {return decode(res.getNext());}
+
+	///Decodes the row
+	/** @exception RangeException row has less fields than the reader needs */
+	Tuple decode(const Row &rw) const {
+		_rowReader::RowAccess::checkRow(rw,need);
+		return decode(rw,typename _rowReader::MakeIndexSeq<sizeof...(T)>::Type());
+	}
+
+protected:
+	Result &res;
+	natural idx[sizeof...(T)];
+	///count of fields needed in the row
+	natural need;
+
+	template<natural... I>
+	Tuple decode(const Row &rw, _rowReader::IndexSeq<I...>) const {
+		return Tuple(_rowReader::RowAccess::get<T>(rw,idx[I])...);
+	}
+};
+
+///Maps column to the member of the structure
+template<typename S, typename M>
+struct FieldMap {
+	ConstStrA name;
+	M S::*member;
+};
+
+///Creates mapping of the column to the member
+/**
+ * @param name name of the column
+ * @param member pointer to member
+ */
+template<typename S, typename M>
+FieldMap<S,M> mapField(ConstStrA name, M S::*member) {
+	FieldMap<S,M> f = {name,member};
+	return f;
+}
+
+///Reads rows of the result to the structure
+/**
+ * @code
+ * struct User {
+ *     long long id;
+ *     StringA name;
+ * };
+ *
+ * auto rd = readStruct(res, mapField("id",&User::id), mapField("name",&User::name));
+ * while (rd.hasItems()) {
+ *     User u = rd.getNext();
+ * }
+ * @endcode
+ *
+ * @see TupleReader
+ */
+template<typename S, typename... M>
+class StructReader {
+public:
+	StructReader(Result &res, FieldMap<S,M>... fields):res(res),members(fields.member...) {
+		ConstStrA names[] = {fields.name...};
+		need = _rowReader::resolveFields(res,names,sizeof...(M),idx);
+	}
+
+	bool hasItems() const {return res.hasItems();}
+	S getNext() {
+		S out;
+		decode(res.getNext(),out);
+		return out;
+	}
+
+	///Decodes the row into the structure
+	/** @exception RangeException row has less fields than the reader needs */
+	void decode(const Row &rw, S &out) const {
+		_rowReader::RowAccess::checkRow(rw,need);
+		decode(rw,out,typename _rowReader::MakeIndexSeq<sizeof...(M)>::Type());
+	}
+
+protected:
+	Result &res;
+	std::tuple<M S::*...> members;
+	natural idx[sizeof...(M)];
+	///count of fields needed in the row
+	natural need;
+
+	template<natural... I>
+	void decode(const Row &rw, S &out, _rowReader::IndexSeq<I...>) const {
+		int dummy[] = {(out.*std::get<I>(members) = _rowReader::RowAccess::get<M>(rw,idx[I]), 0)...};
+		(void)dummy;
+	}
+};
+
+///Creates StructReader
+template<typename S, typename... M>
+StructReader<S,M...> readStruct(Result &res, FieldMap<S,M>... fields) {
+	return StructReader<S,M...>(res,fields...);
+}
+
+}
+
+#endif
+
+#endif /* LIGHTMYSQL_ROWREADER_H_ */
@@ -12,10 +12,11 @@
 namespace LightMySQL {
 
 std::string FieldTypeConv<std::string>::convert(const FieldContent &f) {
-	return std::string(f.value,f.length);
+	ConstStrA val = f.getText();
+	return std::string(val.data(),val.length());
 }
 std::wstring FieldTypeConv<std::wstring>::convert(const FieldContent &f) {
-	ConstStrA val(f.value,f.length);
+	ConstStrA val = f.getText();
 	String wval = val;
 	return std::wstring(wval.data(),wval.length());
 }
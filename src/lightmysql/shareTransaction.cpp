@@ -146,6 +146,10 @@ StringA ShareTrnSyncPoint::QueryEx::escapeString(ConstStrA str)  {
 			return nextHop->escapeString(str);
 		}
 
+void ShareTrnSyncPoint::QueryEx::escapeString(ConstStrA str, AutoArray<char> &buffer)  {
+			nextHop->escapeString(str,buffer);
+		}
+
 void ShareTrnSyncPoint::QueryEx::startTransaction(Level isolationLevel)  {
 			nextHop = owner.onStart(pool,isolationLevel);
 		}
@@ -120,6 +120,7 @@ protected:
 
 		virtual Result executeQuery(ConstStrA query);
 		virtual StringA escapeString(ConstStrA str);
+		virtual void escapeString(ConstStrA str, AutoArray<char> &buffer);
 		virtual void startTransaction(Level isolationLevel);
 		virtual void commitTransaction();
 		virtual void rollbackTransaction();
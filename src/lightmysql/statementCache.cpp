@@ -0,0 +1,166 @@
+/*
+ * statementCache.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "statementCache.h"
+#include "connection.h"
+#include "preparedQuery.h"
+#include "mysql/mysqld_error.h"
+#include "mysql/errmsg.h"
+#include <lightspeed/base/containers/autoArray.tcc>
+
+namespace LightMySQL {
+
+StatementCache::StatementCache(Connection &conn, natural maxCount)
+	:conn(conn),maxCount(maxCount),session(0),useCounter(0),used(0)
+	,hits(0),misses(0),evictions(0)
+{
+}
+
+StatementCache::~StatementCache() {
+	clear();
+}
+
+MYSQL_STMT *StatementCache::get(ConstStrA stmtText) {
+	if (session != conn.getSessionCounter()) {
+		//connection has been reopened, statements are no longer valid
+		clear();
+		session = conn.getSessionCounter();
+	}
+	const natural *pos = index.find(stmtText);
+	if (pos) {
+		hits++;
+		Slot &s = slots(*pos);
+		s.lastUse = ++useCounter;
+		return s.stmt;
+	}
+	misses++;
+	natural limit = getLimit();
+	//pinned statements are not evicted, the limit can be exceeded
+	while (used && used >= limit && evict()) {}
+	MYSQL_STMT *stmt = prepare(stmtText);
+	natural p = allocSlot();
+	Slot &s = slots(p);
+	s.text = stmtText;
+	s.stmt = stmt;
+	s.lastUse = ++useCounter;
+	index.insert(s.text,p);
+	used++;
+	return stmt;
+}
+
+MYSQL_STMT *StatementCache::prepare(ConstStrA stmtText) {
+	MYSQL *sql = &conn.conn;
+	for(;;) {
+		MYSQL_STMT *stmt = mysql_stmt_init(sql);
+		if (stmt == 0)
+			throw ServerError_t(THISLOCATION,mysql_errno(sql),mysql_error(sql));
+		MyBool updateMaxLength = 1;
+		mysql_stmt_attr_set(stmt,STMT_ATTR_UPDATE_MAX_LENGTH,&updateMaxLength);
+		if (mysql_stmt_prepare(stmt,stmtText.data(),stmtText.length()) == 0)
+			return stmt;
+
+		unsigned int err = mysql_stmt_errno(stmt);
+		StringA msg = mysql_stmt_error(stmt);
+		mysql_stmt_close(stmt);
+		//server's limit is shared by all connections - make a room and try again
+		if (err == ER_MAX_PREPARED_STMT_COUNT_REACHED && evict())
+			continue;
+		IDebugLog *log = conn.getLogObject();
+		if (log) log->onQueryError(msg);
+		if (err == CR_SERVER_GONE_ERROR || err == CR_SERVER_LOST)
+			conn.handleError(THISLOCATION);
+		throw ServerError_t(THISLOCATION,err,msg);
+	}
+}
+
+natural StatementCache::getLimit() {
+	//limit of the server is read on the first miss in the session, the
+	//connection is idle here (checked by the PreparedQuery)
+	natural serverLimit = conn.getMaxPreparedStatements();
+	return serverLimit < maxCount?serverLimit:maxCount;
+}
+
+natural StatementCache::allocSlot() {
+	for (natural i = 0; i < slots.length(); i++)
+		if (slots[i].stmt == 0) return i;
+	slots.add(Slot());
+	return slots.length() - 1;
+}
+
+void StatementCache::freeSlot(natural pos) {
+	Slot &s = slots(pos);
+	index.erase(s.text);
+	releaseSlot(pos);
+	s.text = StringA();
+	used--;
+}
+
+void StatementCache::releaseSlot(natural pos) {
+	Slot &s = slots(pos);
+	//pinned statement is closed by the pin
+	if (s.pin) s.pin->owner = 0;
+	else mysql_stmt_close(s.stmt);
+	s.pin = 0;
+	s.stmt = 0;
+}
+
+bool StatementCache::evict() {
+	natural lru = naturalNull;
+	for (natural i = 0; i < slots.length(); i++) {
+		const Slot &s = slots[i];
+		if (s.stmt && s.pin == 0 && (lru == naturalNull || s.lastUse < slots[lru].lastUse))
+			lru = i;
+	}
+	if (lru == naturalNull) return false;
+	freeSlot(lru);
+	evictions++;
+	return true;
+}
+
+StatementCache::PPin StatementCache::pin(ConstStrA stmtText) {
+	const natural *pos = index.find(stmtText);
+	if (pos == 0) return PPin();
+	Slot &s = slots(*pos);
+	if (s.pin == 0) s.pin = new Pin(this,*pos,s.stmt);
+	return PPin(s.pin);
+}
+
+StatementCache::Pin::~Pin() {
+	if (owner) owner->slots(slot).pin = 0;
+	//statement has been removed from the cache while it was pinned
+	else mysql_stmt_close(stmt);
+}
+
+void StatementCache::remove(ConstStrA stmtText) {
+	const natural *pos = index.find(stmtText);
+	if (pos) freeSlot(*pos);
+}
+
+void StatementCache::clear() {
+	for (natural i = 0; i < slots.length(); i++) {
+		//statement can be closed even if the connection is already closed
+		if (slots[i].stmt) releaseSlot(i);
+	}
+	index.clear();
+	slots.clear();
+	used = 0;
+}
+
+StatementCache::Stats StatementCache::getStats() const {
+	Stats st;
+	st.hits = hits;
+	st.misses = misses;
+	st.evictions = evictions;
+	st.size = used;
+	return st;
+}
+
+void StatementCache::resetStats() {
+	hits = misses = evictions = 0;
+}
+
+}
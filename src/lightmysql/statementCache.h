@@ -0,0 +1,161 @@
+/*
+ * statementCache.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_STATEMENTCACHE_H_
+#define LIGHTMYSQL_STATEMENTCACHE_H_
+
+#include <mysql/mysql.h>
+#include <lightspeed/base/containers/autoArray.h>
+#include <lightspeed/base/containers/map.h>
+#include <lightspeed/base/containers/string.h>
+#include <lightspeed/base/memory/refCntPtr.h>
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+class Connection;
+
+///Cache of prepared statements of single connection
+/**
+ * Object keeps statements prepared on the connection, so the repeated
+ * execution of the same query doesn't need to prepare the statement again.
+ * Statements are identified by the text sent to the server (with '?' placeholders).
+ *
+ * Count of statements is limited by the maxCount and by the server's
+ * variable max_prepared_stmt_count. When the cache is full, the least
+ * recently used statement is closed.
+ *
+ * Whole cache is dropped when the connection is closed or reconnected. Statements
+ * are owned by the cache, the caller should not keep the returned handle
+ * after the next call of the get(), unless the statement is pinned (see pin()).
+ * Pinned statement is not evicted. If it is removed from the cache, it is
+ * closed when the last pin is released.
+ */
+class StatementCache {
+public:
+
+	///Statistics of the cache
+	struct Stats {
+		///count of requests served from the cache
+		natural hits;
+		///count of requests which caused preparing the statement
+		natural misses;
+		///count of statements closed to make a room for another one
+		natural evictions;
+		///count of statements currently in the cache
+		natural size;
+	};
+
+	///Keeps the statement alive
+	/** Statement is released, when the last reference to the object is released */
+	class Pin: public RefCntObj {
+	public:
+		~Pin();
+	protected:
+		Pin(StatementCache *owner, natural slot, MYSQL_STMT *stmt)
+			:owner(owner),slot(slot),stmt(stmt) {}
+		///cache, or NULL, if the statement has been removed from the cache
+		StatementCache *owner;
+		natural slot;
+		MYSQL_STMT *stmt;
+		friend class StatementCache;
+	};
+
+	typedef RefCntPtr<Pin> PPin;
+
+	///default maximum count of cached statements
+	static const natural defaultMaxCount = 512;
+
+	///Construct the cache
+	/**
+	 * @param conn connection
+	 * @param maxCount maximum count of the statements
+	 */
+	StatementCache(Connection &conn, natural maxCount = defaultMaxCount);
+	///Destructor - closes all statements
+	~StatementCache();
+
+	///Retrieves prepared statement
+	/**
+	 * @param stmtText statement text
+	 * @return prepared statement. If the statement is not in the cache, it is
+	 * prepared now. Function can close the least recently used statement.
+	 * @exception ServerError_t unable to prepare the statement
+	 */
+	MYSQL_STMT *get(ConstStrA stmtText);
+
+	///Pins the statement
+	/**
+	 * @param stmtText statement text
+	 * @return pin of the statement, or NULL, if the statement is not in the cache.
+	 * Statement is not evicted or closed while the pin exists
+	 */
+	PPin pin(ConstStrA stmtText);
+
+	///Removes and closes the statement
+	/** Use to remove statement which is no longer usable (after an error) */
+	void remove(ConstStrA stmtText);
+
+	///Closes all statements
+	void clear();
+
+	///Sets maximum count of statements
+	/** If the cache contains more statements, they are evicted on next miss */
+	void setMaxCount(natural count) {maxCount = count;}
+	///Retrieves maximum count of statements
+	natural getMaxCount() const {return maxCount;}
+
+	///Retrieves statistics
+	Stats getStats() const;
+	///Resets counters of the statistics
+	void resetStats();
+
+protected:
+
+	struct Slot {
+		///statement text, it is also storage of the key
+		StringA text;
+		///statement, NULL if slot is free
+		MYSQL_STMT *stmt;
+		///value of useCounter at last use
+		natural lastUse;
+		///current pin of the statement, NULL if not pinned
+		Pin *pin;
+
+		Slot():stmt(0),lastUse(0),pin(0) {}
+	};
+
+	typedef Map<ConstStrA, natural> SlotMap;
+
+	Connection &conn;
+	natural maxCount;
+	///session of the connection, where statements has been prepared
+	natural session;
+	natural useCounter;
+	natural used;
+	AutoArray<Slot> slots;
+	///maps statement text to the index of slot
+	SlotMap index;
+
+	natural hits, misses, evictions;
+
+	MYSQL_STMT *prepare(ConstStrA stmtText);
+	natural allocSlot();
+	void freeSlot(natural pos);
+	bool evict();
+	natural getLimit();
+	void releaseSlot(natural pos);
+
+private:
+	StatementCache(const StatementCache &other);
+	StatementCache &operator=(const StatementCache &other);
+};
+
+}
+
+#endif /* LIGHTMYSQL_STATEMENTCACHE_H_ */
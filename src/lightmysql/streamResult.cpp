@@ -0,0 +1,109 @@
+/*
+ * streamResult.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#include "streamResult.h"
+#include "mysql/errmsg.h"
+
+namespace LightMySQL {
+
+StreamResult::StreamResult(Connection &conn):Result(useResult(conn)) {
+	if (cur->resPtr) {
+		state = new StreamState(conn,cur->resPtr);
+		conn.streaming = true;
+	} else {
+		//statement without rows, nothing to stream
+		if (cur->myerrno) conn.handleError(THISLOCATION);
+		discardResults(conn);
+	}
+}
+
+Result::ResultInfo StreamResult::useResult(Connection &conn) {
+	MYSQL_RES *res = mysql_use_result(&conn.conn);
+	//count of rows is not known yet, result is logged when the stream is finished
+	return makeResultInfo(conn.conn,res,res?0:conn.getLogObject());
+}
+
+void StreamResult::finishStream(StreamState &st) {
+	if (!st.open) return;
+	st.open = false;
+	Connection &conn = st.conn;
+	//connection has been closed, the stream has been lost with it
+	if (!conn.isConnected() || conn.getSessionCounter() != st.session) return;
+	//client library needs to read all rows before the next command
+	while (mysql_fetch_row(st.res) != 0) {}
+	conn.streaming = false;
+	IDebugLog *log = conn.getLogObject();
+	if (log) log->onQueryResult(mysql_num_rows(st.res),mysql_num_fields(st.res),0,0,mysql_warning_count(&conn.conn));
+	discardResults(conn);
+}
+
+void StreamResult::discardResults(Connection &conn) {
+	MYSQL &sql = conn.conn;
+	while (mysql_more_results(&sql)) {
+		if (mysql_next_result(&sql) > 0) {
+			IDebugLog *log = conn.getLogObject();
+			if (log) log->onQueryError(mysql_error(&sql));
+			break;
+		}
+		MYSQL_RES *res = mysql_use_result(&sql);
+		if (res) mysql_free_result(res);
+	}
+}
+
+void StreamResult::loadNextRow() const {
+	checkResult(THISLOCATION);
+	readyRow = 0;
+	if (state == nil || !state->open) return;
+	Connection &conn = state->conn;
+	if (!conn.isConnected() || conn.getSessionCounter() != state->session) {
+		state->open = false;
+		throw ServerError_t(THISLOCATION,CR_SERVER_LOST,"Connection has been closed while the result was streamed");
+	}
+	readyRow = mysql_fetch_row(state->res);
+	if (readyRow) {
+		readyLengths = mysql_fetch_lengths(state->res);
+		state->rows++;
+	} else if (mysql_errno(&conn.conn)) {
+		//connection failed during transfer, the rest of the result is lost
+		state->open = false;
+		conn.streaming = false;
+		IDebugLog *log = conn.getLogObject();
+		if (log) log->onQueryError(mysql_error(&conn.conn));
+		conn.handleError(THISLOCATION);
+	} else {
+		finishStream(*state);
+	}
+}
+
+void StreamResult::cancel() {
+	if (state != nil) finishStream(*state);
+	readyRow = 0;
+}
+
+bool StreamResult::isOpen() const {
+	return state != nil && state->open;
+}
+
+void StreamResult::rewind() {
+	//rewind is allowed until the first row is consumed (begin() calls it)
+	if (state != nil && state->rows > (readyRow?1:0))
+		throw StreamPositionException_t(THISLOCATION);
+}
+
+MYSQL_ROW_OFFSET StreamResult::tell() const {
+	throw StreamPositionException_t(THISLOCATION);
+}
+
+void StreamResult::seek(MYSQL_ROW_OFFSET ) {
+	throw StreamPositionException_t(THISLOCATION);
+}
+
+void StreamPositionException_t::message(LightSpeed::ExceptionMsg &msg) const {
+	msg("Streamed result can be read only once, position cannot be changed");
+}
+
+}
@@ -0,0 +1,138 @@
+/*
+ * streamResult.h
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTMYSQL_STREAMRESULT_H_
+#define LIGHTMYSQL_STREAMRESULT_H_
+
+#include <lightspeed/base/memory/refCntPtr.h>
+#include "result.h"
+
+namespace LightMySQL {
+
+using namespace LightSpeed;
+
+///Result which reads rows directly from the server (unbuffered)
+/**
+ * Object is created by Connection::executeStream() or Query::execStream().
+ * Rows are not stored in the client memory (mysql_use_result()), so memory
+ * usage doesn't depend on the size of the result, and the first row is
+ * available as soon as the server sends it.
+ *
+ * @code
+ * StreamResult res = q("SELECT * FROM log").execStream();
+ * while (res.hasItems()) {
+ *     Row rw = res.getNext();
+ *     ...
+ * }
+ * @endcode
+ *
+ * While the stream is open, the connection is busy and any attempt to
+ * execute other query through it throws ServerError_t (CR_COMMANDS_OUT_OF_SYNC).
+ * Stream is closed when the last row is read, when cancel() is called
+ * or when the last copy of the object is destroyed.
+ *
+ * @note Rows can be read only once. Function rewind() (and begin()) is
+ * allowed only before the first row is read, tell() and seek() are not available.
+ * The row returned by getNext() is valid until next row is fetched.
+ * countRows() returns count of rows read so far.
+ *
+ * @note Object cannot be converted to the Result, the stream would be
+ * closed with the temporary object. Keep the connection alive while the
+ * stream is open. Only first result of a multi-statement query can be
+ * streamed, other results are discarded.
+ */
+class StreamResult: protected Result {
+public:
+
+	using Result::Row;
+	using Result::RangeIter;
+	using Result::hasResult;
+	using Result::nextResult;
+	using Result::firstResult;
+	using Result::hasItems;
+	using Result::getNext;
+	using Result::getAffectedRows;
+	using Result::getInsertId;
+	using Result::getWarningCount;
+	using Result::getFieldCount;
+	using Result::getError;
+	using Result::getErrNo;
+	using Result::isError;
+	using Result::throwErrorException;
+	using Result::noTableResult;
+	using Result::empty;
+	using Result::countFields;
+	using Result::countRows;
+	using Result::getFieldName;
+	using Result::getFieldIndex;
+	using Result::getFieldInfo;
+	using Result::begin;
+	using Result::end;
+	using Result::freeze;
+
+	///Reads and discards remaining rows, connection becomes idle
+	/** Note that rows still must be transferred from the server */
+	void cancel();
+	///Determines, whether the stream is open
+	/**
+	 * @retval true stream is open, connection is busy
+	 * @retval false all rows has been read or the stream has been cancelled
+	 */
+	bool isOpen() const;
+
+	virtual void rewind();
+	virtual MYSQL_ROW_OFFSET tell() const;
+	virtual void seek(MYSQL_ROW_OFFSET rc);
+
+protected:
+
+	///state of the stream shared between copies of the result
+	class StreamState: public RefCntObj {
+	public:
+		Connection &conn;
+		MYSQL_RES *res;
+		///session counter when the stream has been opened
+		natural session;
+		///count of fetched rows
+		natural rows;
+		bool open;
+
+		StreamState(Connection &conn, MYSQL_RES *res)
+			:conn(conn),res(res),session(conn.getSessionCounter()),rows(0),open(true) {}
+		~StreamState() {finishStream(*this);}
+	};
+
+	StreamResult(Connection &conn);
+
+	static ResultInfo useResult(Connection &conn);
+	///closes the stream and releases the connection
+	static void finishStream(StreamState &st);
+	///discards remaining results of the multi-statement query
+	static void discardResults(Connection &conn);
+
+	virtual void loadNextRow() const;
+	virtual bool stableRows() const {return false;}
+
+	RefCntPtr<StreamState> state;
+
+	friend class Connection;
+};
+
+///Exception - rows of the streamed result cannot be read again
+class StreamPositionException_t: public Exception_t {
+public:
+	LIGHTSPEED_EXCEPTIONFINAL;
+
+	StreamPositionException_t(const ProgramLocation &loc)
+		:Exception_t(loc) {}
+protected:
+	void message(LightSpeed::ExceptionMsg &msg) const;
+};
+
+}
+
+#endif /* LIGHTMYSQL_STREAMRESULT_H_ */
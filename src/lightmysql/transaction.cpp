@@ -85,13 +85,24 @@ void Transaction::except(const ServerError_t& e,
 		const ProgramLocation& loc) {
 	IConnection &conn = queryObj.getConnection();
 	rollback();
+	natural delay = recoveryDelay(conn,e,retryCount);
+	if (delay != naturalNull) {
+		state = stRecovered;
+		Thread::deepSleep(delay);
+	} else {
+		LightSpeed::Exception::rethrow(loc);
+		throw;
+	}
+
+}
+
+natural Transaction::recoveryDelay(IConnection &conn, const ServerError_t &e, natural &retryCount) {
 	unsigned int err = e.getErrno();
 	if (err == ER_LOCK_DEADLOCK || err == ER_LOCK_WAIT_TIMEOUT) {
 		if (retryCount == 20) {
 			conn.logString("Too many retries to solve deadlock state, giving up",true);
 			throw e;
 		}
-		state = stRecovered;
 		retryCount++;
 		natural delay = retryCount *100;
 		if (conn.isLogEnabled()) {
@@ -100,12 +111,10 @@ void Transaction::except(const ServerError_t& e,
 			sprintf(buff,"Sleeping for %lu miliseconds to recover from a deadlock",delay);
 			conn.logString(buff,false);
 		}
-		Thread::deepSleep(delay);
+		return delay;
 	} else {
-		LightSpeed::Exception::rethrow(loc);
-		throw;
+		return naturalNull;
 	}
-
 }
 
 
@@ -127,6 +136,10 @@ Result Transaction::exec() {
 	 return queryObj.exec();
 }
 
+UpdateResult Transaction::execUpdate() {
+	 return queryObj.execUpdate();
+}
+
 }
 
 /* namespace LightMySQL */
@@ -80,6 +80,20 @@ public:
 
 	void except(const ServerError_t &e, const ProgramLocation &loc);
 
+	///Determines, how to recover from the error
+	/**
+	 * Transaction failed by a deadlock or lock wait timeout can be repeated
+	 * after a short delay. The delay increases with every retry.
+	 *
+	 * @param conn connection (used for logging)
+	 * @param e error
+	 * @param retryCount count of retries. Function increases the value
+	 * @return delay in milliseconds before the transaction is repeated. Function
+	 * returns naturalNull, if the error cannot be recovered
+	 * @exception ServerError_t too many retries, function throws the error
+	 */
+	static natural recoveryDelay(IConnection &conn, const ServerError_t &e, natural &retryCount);
+
 	template<typename Ret>
 	Ret exec(const ProgramLocation &loc, Ret (*fn)(Transaction &trn));
 	template<typename Ret, typename Arg1>
@@ -97,6 +111,8 @@ public:
 
 	///Executes prepared query
 	Result exec();
+	///Executes prepared statement which doesn't return rows
+	UpdateResult execUpdate();
 
 
 	class IsolationLevelRef {
@@ -0,0 +1,197 @@
+/*
+ * escapeTest.cpp
+ *
+ *  Created on: 17. 10. 2026
+ *      Author: ondra
+ *
+ * Differential test of mysqlEscape(). Output of the SIMD code is compared
+ * with mysqlEscapeScalar() and with mysql_real_escape_string() of the client
+ * library on random and boundary inputs (special characters and multi-byte
+ * sequences at every offset around the block boundaries, truncated and
+ * invalid utf-8).
+ *
+ * jsonFindSpecial() is compared with a simple loop on the same inputs.
+ *
+ * Client library needs a connection to know the charset, so the comparison
+ * with mysql_real_escape_string() runs only when the server is specified.
+ * The output is compared with the charset selected by Connection::initEscaping()
+ * for the client library, Connector/C (LIBMARIADB) escapes utf8 as single-byte.
+ *
+ * build:
+ *   clang++ -O2 -mavx2 -Isrc tests/escapeTest.cpp src/lightmysql/escape.cpp \
+ *      -lmysqlclient -o escapeTest
+ *   (build also without -mavx2 to test the SSE2 path)
+ *
+ * run:
+ *   ./escapeTest [host user password]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <mysql/mysql.h>
+#include "lightmysql/escape.h"
+
+using namespace LightMySQL;
+
+struct Charset {
+	EscapeCharset charset;
+	const char *name;
+	///charset used by the Connection for the client library
+	EscapeCharset client;
+};
+
+#ifdef LIBMARIADB
+static const Charset charsets[] = {
+	{escSingleByte,"latin1",escSingleByte},
+	{escUtf8mb3,"utf8",escSingleByte},
+	{escUtf8mb4,"utf8mb4",escSingleByte}
+};
+#else
+static const Charset charsets[] = {
+	{escSingleByte,"latin1",escSingleByte},
+	{escUtf8mb3,"utf8",escUtf8mb3},
+	{escUtf8mb4,"utf8mb4",escUtf8mb4}
+};
+#endif
+
+static const char specials[] = {'\0','\n','\r','\\','\'','"','\032'};
+
+///fragments of utf-8, valid and invalid
+static const char *fragments[] = {
+	"\xC3\xA1",				//2 bytes
+	"\xE2\x82\xAC",			//3 bytes
+	"\xF0\x9F\x98\x80",		//4 bytes (not valid in utf8mb3)
+	"\xC3",					//truncated
+	"\xE2\x82",				//truncated
+	"\xF0\x9F\x98",			//truncated
+	"\xC3\x27",				//lead byte followed by quote
+	"\xE2\x5C\x82",			//backslash inside the sequence
+	"\x80",					//continuation without lead
+	"\xFF",					//invalid byte
+	"\xC0\xAF",				//overlong
+	"\xED\xA0\x80"			//surrogate
+};
+
+static const std::size_t fragmentCount = sizeof(fragments)/sizeof(fragments[0]);
+
+static MYSQL *server[3];
+static unsigned long failures = 0;
+static unsigned long tests = 0;
+
+static void dump(const char *label, const char *s, std::size_t len) {
+	printf("  %-10s",label);
+	for (std::size_t i = 0; i < len; i++) printf(" %02X",(unsigned char)s[i]);
+	printf("\n");
+}
+
+static void checkJson(const std::string &input) {
+	std::size_t ref = 0;
+	while (ref < input.length() && (unsigned char)input[ref] >= 0x20
+			&& input[ref] != '"' && input[ref] != '\\') ref++;
+	tests++;
+	std::size_t r = jsonFindSpecial(input.data(),input.length());
+	if (r != ref && failures++ < 10) {
+		printf("Mismatch of jsonFindSpecial, result %lu, expected %lu\n",(unsigned long)r,(unsigned long)ref);
+		dump("input",input.data(),input.length());
+	}
+}
+
+static void check(const std::string &input) {
+	std::vector<char> a(input.length() * 2 + 1), b(input.length() * 2 + 1), c(input.length() * 2 + 1);
+	for (int i = 0; i < 3; i++) {
+		tests++;
+		std::size_t la = mysqlEscape(&a[0],input.data(),input.length(),charsets[i].charset);
+		std::size_t lb = mysqlEscapeScalar(&b[0],input.data(),input.length(),charsets[i].charset);
+		bool ok = la == lb && memcmp(&a[0],&b[0],la) == 0 && a[la] == 0;
+		std::size_t lc = 0;
+		if (ok && server[i]) {
+			if (charsets[i].client != charsets[i].charset)
+				la = mysqlEscape(&a[0],input.data(),input.length(),charsets[i].client);
+			lc = mysql_real_escape_string(server[i],&c[0],input.data(),(unsigned long)input.length());
+			ok = la == lc && memcmp(&a[0],&c[0],la) == 0;
+		}
+		if (!ok) {
+			if (failures++ < 10) {
+				printf("Mismatch, charset %s\n",charsets[i].name);
+				dump("input",input.data(),input.length());
+				dump("simd",&a[0],la);
+				dump("scalar",&b[0],lb);
+				if (server[i]) dump("libmysql",&c[0],lc);
+			}
+		}
+	}
+	checkJson(input);
+}
+
+static std::string filler(std::size_t len) {
+	std::string s;
+	for (std::size_t i = 0; i < len; i++) s.push_back((char)('a' + i % 26));
+	return s;
+}
+
+///special characters and fragments at every offset around the block boundaries
+static void boundaryTests() {
+	check(std::string());
+	for (std::size_t len = 1; len <= 100; len++) {
+		check(filler(len));
+		for (std::size_t pos = 0; pos < len; pos++) {
+			for (std::size_t k = 0; k < sizeof(specials); k++) {
+				std::string s = filler(len);
+				s[pos] = specials[k];
+				check(s);
+			}
+			for (std::size_t k = 0; k < fragmentCount; k++) {
+				std::string s = filler(len);
+				s.insert(pos,fragments[k]);
+				check(s);
+				//fragment at the end of the input
+				check(filler(pos) + fragments[k]);
+			}
+		}
+	}
+}
+
+static void randomTests(unsigned long count) {
+	srand(12345);
+	for (unsigned long n = 0; n < count; n++) {
+		std::string s;
+		std::size_t len = rand() % 300;
+		while (s.length() < len) {
+			int r = rand() % 100;
+			if (r < 60) s.push_back((char)(' ' + rand() % 95));
+			else if (r < 75) s.push_back(specials[rand() % sizeof(specials)]);
+			else if (r < 95) s.append(fragments[rand() % fragmentCount]);
+			else s.push_back((char)(rand() % 256));
+		}
+		check(s);
+	}
+}
+
+static MYSQL *openServer(char **argv, const char *charset) {
+	MYSQL *m = mysql_init(0);
+	if (!mysql_real_connect(m,argv[1],argv[2],argv[3],0,0,0,0)) {
+		fprintf(stderr,"Connect failed: %s\n",mysql_error(m));
+		exit(2);
+	}
+	if (mysql_set_character_set(m,charset)) {
+		fprintf(stderr,"Charset %s: %s\n",charset,mysql_error(m));
+		exit(2);
+	}
+	return m;
+}
+
+int main(int argc, char **argv) {
+	if (argc >= 4) {
+		for (int i = 0; i < 3; i++) server[i] = openServer(argv,charsets[i].name);
+	} else {
+		printf("Server is not specified, mysql_real_escape_string() is not tested\n");
+	}
+	boundaryTests();
+	randomTests(200000);
+	for (int i = 0; i < 3; i++) if (server[i]) mysql_close(server[i]);
+	printf("%lu tests, %lu failures\n",tests,failures);
+	return failures?1:0;
+}